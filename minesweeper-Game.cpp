@@ -1,304 +1,6876 @@
 #include <iostream>
 #include <vector>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
+#include <chrono>
 #include <iomanip>
 #include <queue>
+#include <unordered_map>
+#include <random>
+#include <string>
+#include <charconv>
+#include <climits>
+#include <sstream>
+#include <fstream>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <cmath>
+#include <algorithm>
+#include <memory>
+#include <array>
+#include <cerrno>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <csignal>
+#endif
 
 using namespace std;
 
-class Minesweeper {
+// Population count of a 64-bit word
+inline int popcount64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// Index of the lowest set bit of a nonzero 64-bit word
+inline int lowestBit64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    return popcount64((x & (0 - x)) - 1);
+#endif
+}
+
+// Index of the highest set bit of a nonzero 64-bit word
+inline int highestBit64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(x);
+#else
+    x |= x >> 1;
+    x |= x >> 2;
+    x |= x >> 4;
+    x |= x >> 8;
+    x |= x >> 16;
+    x |= x >> 32;
+    return popcount64(x) - 1;
+#endif
+}
+
+// DSA: Optional hot-path instrumentation, compiled in with
+// -DMINESWEEPER_INSTRUMENT. Each thread counts into its own slots (single
+// writer, relaxed atomics, so no lock and no shared cache line on the hot
+// path) and a dump merges every thread. Latencies and sizes go into log2
+// histograms: bucket b holds values in [2^(b-1), 2^b).
+// Without the flag the macros expand to nothing.
+#ifdef MINESWEEPER_INSTRUMENT
+class Instrumentation {
+public:
+    enum Op { PLACE_MINES, CALCULATE_NUMBERS, REVEAL_CELL, CHECK_WIN, RENDER, OP_COUNT };
+    static const int BUCKETS = 48;
+    
+private:
+    struct Counters {
+        atomic<long long> calls, totalNs, maxNs, sizeTotal, sizeMax;
+        atomic<long long> latency[BUCKETS], size[BUCKETS];
+    };
+    
+    // Per-thread slots, registered for the lifetime of the thread
+    struct Local {
+        Counters ops[OP_COUNT];
+        Local();
+        ~Local();
+    };
+    
+    struct Registry {
+        mutex lock;
+        vector<Local*> threads;
+        long long retired[OP_COUNT][5 + 2 * BUCKETS];   // totals of finished threads
+    };
+    
+    static Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+    
+    static Counters& slot(Op op) {
+        thread_local Local local;
+        return local.ops[op];
+    }
+    
+    static void bump(atomic<long long>& counter, long long value) {
+        counter.store(counter.load(memory_order_relaxed) + value, memory_order_relaxed);
+    }
+    
+    static void raise(atomic<long long>& counter, long long value) {
+        if (value > counter.load(memory_order_relaxed)) counter.store(value, memory_order_relaxed);
+    }
+    
+    static int bucketOf(long long value) {
+        int bucket = value <= 0 ? 0 : highestBit64((uint64_t)value) + 1;
+        return min(bucket, BUCKETS - 1);
+    }
+    
+    // Flatten one slot: calls, totalNs, maxNs, sizeTotal, sizeMax, latency[], size[]
+    static void snapshot(const Counters& c, long long* out) {
+        out[0] = c.calls.load(memory_order_relaxed);
+        out[1] = c.totalNs.load(memory_order_relaxed);
+        out[2] = c.maxNs.load(memory_order_relaxed);
+        out[3] = c.sizeTotal.load(memory_order_relaxed);
+        out[4] = c.sizeMax.load(memory_order_relaxed);
+        for (int b = 0; b < BUCKETS; b++) {
+            out[5 + b] = c.latency[b].load(memory_order_relaxed);
+            out[5 + BUCKETS + b] = c.size[b].load(memory_order_relaxed);
+        }
+    }
+    
+    static void accumulate(long long* total, const long long* part) {
+        total[0] += part[0];
+        total[1] += part[1];
+        total[2] = max(total[2], part[2]);
+        total[3] += part[3];
+        total[4] = max(total[4], part[4]);
+        for (int i = 5; i < 5 + 2 * BUCKETS; i++) total[i] += part[i];
+    }
+    
+    // Upper bound of the bucket holding the q-quantile
+    static long long quantile(const long long* histogram, long long count, double q) {
+        long long seen = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            seen += histogram[b];
+            if (seen > 0 && seen >= q * count) return b == 0 ? 0 : 1LL << b;
+        }
+        return 0;
+    }
+    
+public:
+    // Times one call from construction to destruction
+    class Timer {
+    private:
+        Op op;
+        chrono::steady_clock::time_point started;
+        
+    public:
+        explicit Timer(Op timedOp) : op(timedOp), started(chrono::steady_clock::now()) {}
+        ~Timer() {
+            long long ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - started).count();
+            Counters& c = slot(op);
+            bump(c.calls, 1);
+            bump(c.totalNs, ns);
+            raise(c.maxNs, ns);
+            bump(c.latency[bucketOf(ns)], 1);
+        }
+    };
+    
+    // Work size of one call (cells touched, bytes written...)
+    static void recordSize(Op op, long long value) {
+        Counters& c = slot(op);
+        bump(c.sizeTotal, value);
+        raise(c.sizeMax, value);
+        bump(c.size[bucketOf(value)], 1);
+    }
+    
+    // Write every operation's counters merged over all threads, as text
+    // lines or as one JSON object per line
+    static void dump(ostream& out, bool json) {
+        static const char* names[OP_COUNT] = {"placeMines", "calculateNumbers", "revealCell", "checkWin", "render"};
+        long long totals[OP_COUNT][5 + 2 * BUCKETS];
+        {
+            Registry& reg = registry();
+            lock_guard<mutex> guard(reg.lock);
+            memcpy(totals, reg.retired, sizeof(totals));
+            long long part[5 + 2 * BUCKETS];
+            for (Local* local : reg.threads) {
+                for (int op = 0; op < OP_COUNT; op++) {
+                    snapshot(local->ops[op], part);
+                    accumulate(totals[op], part);
+                }
+            }
+        }
+        for (int op = 0; op < OP_COUNT; op++) {
+            const long long* t = totals[op];
+            long long calls = t[0];
+            long long sizeCount = 0;
+            for (int b = 0; b < BUCKETS; b++) sizeCount += t[5 + BUCKETS + b];
+            double mean = calls > 0 ? (double)t[1] / calls : 0.0;
+            long long p50 = quantile(t + 5, calls, 0.5), p99 = quantile(t + 5, calls, 0.99);
+            if (json) {
+                out << "{\"op\":\"" << names[op] << "\",\"calls\":" << calls << ",\"total_ns\":" << t[1]
+                    << ",\"mean_ns\":" << mean << ",\"p50_ns\":" << p50 << ",\"p99_ns\":" << p99
+                    << ",\"max_ns\":" << t[2] << ",\"latency_log2_ns\":[";
+                for (int b = 0; b < BUCKETS; b++) out << (b ? "," : "") << t[5 + b];
+                out << "],\"size_mean\":" << (sizeCount > 0 ? (double)t[3] / sizeCount : 0.0)
+                    << ",\"size_max\":" << t[4] << ",\"size_log2\":[";
+                for (int b = 0; b < BUCKETS; b++) out << (b ? "," : "") << t[5 + BUCKETS + b];
+                out << "]}\n";
+            } else {
+                out << left << setw(18) << names[op] << right << " calls=" << calls << " mean_ns=" << (long long)mean
+                    << " p50_ns<=" << p50 << " p99_ns<=" << p99 << " max_ns=" << t[2];
+                if (sizeCount > 0) {
+                    out << " size_mean=" << (double)t[3] / sizeCount << " size_max=" << t[4];
+                }
+                out << "\n";
+            }
+        }
+    }
+};
+
+inline Instrumentation::Local::Local() {
+    for (Counters& c : ops) {
+        c.calls = c.totalNs = c.maxNs = c.sizeTotal = c.sizeMax = 0;
+        for (int b = 0; b < BUCKETS; b++) c.latency[b] = c.size[b] = 0;
+    }
+    Registry& reg = registry();
+    lock_guard<mutex> guard(reg.lock);
+    reg.threads.push_back(this);
+}
+
+inline Instrumentation::Local::~Local() {
+    Registry& reg = registry();
+    lock_guard<mutex> guard(reg.lock);
+    long long part[5 + 2 * BUCKETS];
+    for (int op = 0; op < OP_COUNT; op++) {
+        snapshot(ops[op], part);
+        accumulate(reg.retired[op], part);
+    }
+    reg.threads.erase(find(reg.threads.begin(), reg.threads.end(), this));
+}
+
+inline void dumpInstrumentation(ostream& out, bool json) {
+    Instrumentation::dump(out, json);
+}
+
+#define MS_TIMED(op) Instrumentation::Timer instrumentTimer(Instrumentation::op)
+#define MS_RECORD_SIZE(op, value) Instrumentation::recordSize(Instrumentation::op, (long long)(value))
+#else
+inline void dumpInstrumentation(ostream& out, bool) {
+    out << "instrumentation disabled (build with -DMINESWEEPER_INSTRUMENT)\n";
+}
+
+#define MS_TIMED(op) ((void)0)
+#define MS_RECORD_SIZE(op, value) ((void)0)
+#endif
+
+// DSA: xoshiro256** pseudo-random generator (per-instance, reproducible)
+class Xoshiro256 {
+private:
+    uint64_t s[4];
+    
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+    
+public:
+    explicit Xoshiro256(uint64_t seed = 0) { reseed(seed); }
+    
+    // Expand a 64-bit seed into the full state with splitmix64
+    void reseed(uint64_t seed) {
+        for (int i = 0; i < 4; i++) {
+            seed += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            s[i] = z ^ (z >> 31);
+        }
+    }
+    
+    uint64_t next() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+    
+    // Unbiased integer in [0, bound) (Lemire's multiply-and-reject)
+    uint32_t nextBelow(uint32_t bound) {
+        uint64_t m = (uint64_t)(uint32_t)next() * bound;
+        uint32_t low = (uint32_t)m;
+        if (low < bound) {
+            uint32_t threshold = (uint32_t)(-bound) % bound;
+            while (low < threshold) {
+                m = (uint64_t)(uint32_t)next() * bound;
+                low = (uint32_t)m;
+            }
+        }
+        return (uint32_t)(m >> 32);
+    }
+};
+
+// Independent seed for item `index` of a stream rooted at `base`
+// (splitmix64 finalizer), so results do not depend on who generates them
+inline uint64_t streamSeed(uint64_t base, uint64_t index) {
+    uint64_t z = base + (index + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Fresh seed for games started without an explicit one
+inline uint64_t randomSeed() {
+    random_device device;
+    return ((uint64_t)device() << 32) ^ device() ^ (uint64_t)time(nullptr);
+}
+
+// Cell encoding: every cell is packed into one byte
+//   bits 0-3 : number of adjacent mines (0-8)
+//   bit 4    : mine
+//   bit 5    : revealed
+//   bit 6    : flagged
+//   bit 7    : border (padding cell outside the playable board)
+const uint8_t COUNT_MASK   = 0x0F;
+const uint8_t MINE_BIT     = 0x10;
+const uint8_t REVEALED_BIT = 0x20;
+const uint8_t FLAGGED_BIT  = 0x40;
+const uint8_t BORDER_BIT   = 0x80;
+
+// Boards with at least one mine per DENSE_NUMBERING_RATIO cells are numbered
+// with the row stencil instead of the per-mine scatter
+const int DENSE_NUMBERING_RATIO = 64;
+
+// Running game counters, maintained by revealCell/toggleFlag
+struct GameStats {
+    int cellsRevealed;   // revealed cells, including a detonated mine
+    int safeRevealed;    // revealed non-mine cells
+    int flagsPlaced;     // cells currently flagged
+    int correctFlags;    // flags sitting on mines
+    int safeCells;       // rows * cols - totalMines
+};
+
+// How the first reveal is treated
+enum StartMode {
+    START_ANYWHERE,      // mines placed up front; the first click may hit one
+    START_SAFE,          // mines placed on the first reveal, away from its 3x3
+    START_NO_GUESS       // as START_SAFE, and the board is solvable without guessing
+};
+
+// Cost of building a no-guess board
+struct GenerationReport {
+    int passes;          // solver passes over the board (the last one is clean)
+    int repairs;         // mines moved to unblock the solver
+    int regenerations;   // full re-placements after a repair dead end
+    bool solvable;       // false if the attempt budget ran out
+    double seconds;
+};
+
+// Headless move API: one command from the r x y / f x y grammar
+struct Move {
+    char type;           // 'r' = reveal, 'f' = flag/unflag, 'c' = chord
+    int x, y;
+};
+
+enum MoveStatus {
+    MOVE_APPLIED,        // board changed
+    MOVE_NO_CHANGE,      // legal but nothing to do (already revealed, flagged...)
+    MOVE_INVALID,        // unknown command or coordinates off the board
+    MOVE_GAME_ENDED      // the game was already won or lost
+};
+
+struct MoveResult {
+    MoveStatus status;
+    bool gameOver;               // a mine was revealed
+    bool gameWon;
+    const vector<int>* changed;  // board indices changed by the move
+};
+
+// DSA: Board generation kernels. They work on any padded cell array with
+// stride cols + 2, so games, arenas and benchmarks share one implementation.
+
+// Bytes needed for a padded rows x cols board
+inline size_t boardBytes(int rows, int cols) {
+    return (size_t)(rows + 2) * (cols + 2);
+}
+
+// Zero the playable cells and mark the border ring revealed, so neighbor
+// walks never need a bounds check
+inline void initBoardCells(uint8_t* cells, int rows, int cols) {
+    int stride = cols + 2;
+    memset(cells, 0, boardBytes(rows, cols));
+    for (int j = 0; j < stride; j++) {
+        cells[j] = BORDER_BIT | REVEALED_BIT;
+        cells[(size_t)(rows + 1) * stride + j] = BORDER_BIT | REVEALED_BIT;
+    }
+    for (int i = 1; i <= rows; i++) {
+        cells[(size_t)i * stride] = BORDER_BIT | REVEALED_BIT;
+        cells[(size_t)i * stride + cols + 1] = BORDER_BIT | REVEALED_BIT;
+    }
+}
+
+// Floyd's sampling: one unbiased draw per mine, the board is the sample set.
+// Appends the board index of every mine to mineCells.
+inline void placeMinesFloyd(uint8_t* cells, int rows, int cols, int mines,
+                            Xoshiro256& rng, vector<int>& mineCells) {
+    int stride = cols + 2;
+    int totalCells = rows * cols;
+    mineCells.reserve(mineCells.size() + mines);
+    for (int j = totalCells - mines; j < totalCells; j++) {
+        int k = (int)rng.nextBelow((uint32_t)j + 1);
+        
+        // If cell k already holds a mine, cell j cannot yet: place it there
+        int idx = (k / cols + 1) * stride + k % cols + 1;
+        if (cells[idx] & MINE_BIT) {
+            idx = (j / cols + 1) * stride + j % cols + 1;
+        }
+        cells[idx] |= MINE_BIT;
+        mineCells.push_back(idx);
+    }
+}
+
+inline uint64_t load8(const uint8_t* p) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+inline void store8(uint8_t* p, uint64_t word) {
+    memcpy(p, &word, sizeof(word));
+}
+
+// Mine-centric pass: increment the 8 neighbors of every mine.
+// Border cells may collect counts too; they are never read.
+inline void numberBoardSparse(uint8_t* cells, int cols, const vector<int>& mineCells) {
+    int stride = cols + 2;
+    const int offsets[8] = {-stride - 1, -stride, -stride + 1, -1, 1, stride - 1, stride, stride + 1};
+    for (int idx : mineCells) {
+        for (int k = 0; k < 8; k++) {
+            cells[idx + offsets[k]]++;
+        }
+    }
+}
+
+// Row-wise stencil: sum the mine bits of three stacked rows per column,
+// then add each column sum to its left and right neighbors. Eight
+// cells are processed per step as bytes of a 64-bit word (SWAR), so
+// the kernel is vectorized without depending on compiler flags.
+inline void numberBoardDense(uint8_t* cells, int rows, int cols) {
+    const uint64_t LANE_ONES = 0x0101010101010101ULL;
+    const uint64_t LANE_COUNT = LANE_ONES * COUNT_MASK;
+    int stride = cols + 2;
+    vector<uint8_t> columnSum(stride + 8, 0);
+    
+    for (int i = 1; i <= rows; i++) {
+        const uint8_t* up = cells + (size_t)(i - 1) * stride;
+        const uint8_t* mid = up + stride;
+        const uint8_t* down = mid + stride;
+        uint8_t* out = cells + (size_t)i * stride;
+        
+        int j = 0;
+        for (; j + 8 <= stride; j += 8) {
+            uint64_t sum = ((load8(up + j) >> 4) & LANE_ONES) + ((load8(mid + j) >> 4) & LANE_ONES)
+                         + ((load8(down + j) >> 4) & LANE_ONES);
+            store8(&columnSum[j], sum);
+        }
+        for (; j < stride; j++) {
+            columnSum[j] = (uint8_t)(((up[j] >> 4) & 1) + ((mid[j] >> 4) & 1) + ((down[j] >> 4) & 1));
+        }
+        
+        // Each lane sums to at most 9, so bytes never carry into each other
+        j = 1;
+        for (; j + 8 <= cols + 1; j += 8) {
+            uint64_t center = load8(out + j);
+            uint64_t count = load8(&columnSum[j - 1]) + load8(&columnSum[j]) + load8(&columnSum[j + 1])
+                           - ((center >> 4) & LANE_ONES);
+            store8(out + j, (center & ~LANE_COUNT) | count);
+        }
+        for (; j <= cols; j++) {
+            int count = columnSum[j - 1] + columnSum[j] + columnSum[j + 1] - ((mid[j] >> 4) & 1);
+            out[j] = (uint8_t)((out[j] & ~COUNT_MASK) | count);
+        }
+    }
+}
+
+// Sparse boards scatter +1 around each mine (O(mines)); dense boards use
+// the row stencil. Expects all counts to be zero (freshly placed board).
+inline void numberBoard(uint8_t* cells, int rows, int cols, const vector<int>& mineCells) {
+    if ((int64_t)mineCells.size() * DENSE_NUMBERING_RATIO >= (int64_t)rows * cols) {
+        numberBoardDense(cells, rows, cols);
+    } else {
+        numberBoardSparse(cells, cols, mineCells);
+    }
+}
+
+// Move kernels shared by Minesweeper and PresetGame, over the padded cell
+// array and its stride, so the same seed and moves give the same board on
+// both. Stack is vector<int> or FixedStack (push_back/back/pop_back/empty);
+// reveal(idx) marks one cell revealed and does the caller's bookkeeping.
+
+// Fixed-capacity stand-in for vector<int> as a fill worklist
+template <int N>
+struct FixedStack {
+    array<int, N> items;
+    int top = 0;
+    
+    void clear() { top = 0; }
+    void push_back(int value) { items[top++] = value; }
+    int back() const { return items[top - 1]; }
+    void pop_back() { top--; }
+    bool empty() const { return top == 0; }
+};
+
+// An unrevealed, unflagged cell with no adjacent mines
+inline bool isOpenZeroCell(const uint8_t* cells, int idx) {
+    return (cells[idx] & (COUNT_MASK | MINE_BIT | REVEALED_BIT | FLAGGED_BIT)) == 0;
+}
+
+// Extend the revealed zero cell at seed into its full horizontal span,
+// reveal the span's outline and queue one seed per zero run above/below
+template <typename Stack, typename Reveal>
+inline void fillZeroSpan(uint8_t* cells, int stride, int seed, Stack& stack, Reveal& reveal) {
+    int left = seed, right = seed;
+    while (isOpenZeroCell(cells, left - 1)) reveal(--left);
+    while (isOpenZeroCell(cells, right + 1)) reveal(++right);
+    
+    // Span ends are numbers (or already handled); a zero has no mine neighbors
+    if (!(cells[left - 1] & (REVEALED_BIT | FLAGGED_BIT))) reveal(left - 1);
+    if (!(cells[right + 1] & (REVEALED_BIT | FLAGGED_BIT))) reveal(right + 1);
+    
+    for (int row = -stride; row <= stride; row += 2 * stride) {
+        bool inRun = false;
+        for (int idx = left - 1 + row; idx <= right + 1 + row; idx++) {
+            uint8_t cell = cells[idx];
+            if (cell & (REVEALED_BIT | FLAGGED_BIT)) {
+                inRun = false;
+            } else if ((cell & COUNT_MASK) == 0) {
+                // Rest of this zero run is revealed when the seed expands
+                if (!inRun) {
+                    reveal(idx);
+                    stack.push_back(idx);
+                    inRun = true;
+                }
+            } else {
+                reveal(idx);
+                inRun = false;
+            }
+        }
+    }
+}
+
+template <typename Stack, typename Reveal>
+inline void drainZeroSpans(uint8_t* cells, int stride, Stack& stack, Reveal& reveal) {
+    while (!stack.empty()) {
+        int seed = stack.back();
+        stack.pop_back();
+        fillZeroSpan(cells, stride, seed, stack, reveal);
+    }
+}
+
+// Flood fill on the padded array; border cells count as revealed.
+// Zero cells are revealed a whole horizontal span at a time, and only
+// span seeds are kept on the stack, so memory is bounded by the frontier.
+// Returns true if idx is a mine.
+template <typename Stack, typename Reveal>
+inline bool floodReveal(uint8_t* cells, int stride, int idx, Stack& stack, Reveal&& reveal) {
+    if (cells[idx] & (REVEALED_BIT | FLAGGED_BIT)) return false;
+    reveal(idx);
+    if (cells[idx] & MINE_BIT) return true;
+    if ((cells[idx] & COUNT_MASK) == 0) {
+        stack.clear();
+        stack.push_back(idx);
+        drainZeroSpans(cells, stride, stack, reveal);
+    }
+    return false;
+}
+
+// DSA: Chording - on a revealed number whose adjacent flags match its
+// count, reveal every other hidden neighbor. The flags are checked once,
+// the neighbors are revealed directly and the zero ones all seed one
+// shared span worklist, so overlapping regions are filled only once.
+// Returns true if a misplaced flag let a mine be revealed.
+template <typename Stack, typename Reveal>
+inline bool chordReveal(uint8_t* cells, int stride, const int* offsets, int idx, Stack& stack, Reveal&& reveal) {
+    uint8_t cell = cells[idx];
+    if ((cell & (REVEALED_BIT | MINE_BIT)) != REVEALED_BIT || (cell & COUNT_MASK) == 0) return false;
+    int flags = 0;
+    for (int k = 0; k < 8; k++) flags += (cells[idx + offsets[k]] & FLAGGED_BIT) != 0;
+    if (flags != (cell & COUNT_MASK)) return false;
+    
+    bool hit = false;
+    stack.clear();
+    for (int k = 0; k < 8; k++) {
+        int n = idx + offsets[k];
+        if (cells[n] & (REVEALED_BIT | FLAGGED_BIT)) continue;   // includes the border
+        reveal(n);
+        if (cells[n] & MINE_BIT) {
+            hit = true;   // keep revealing like a click would
+        } else if ((cells[n] & COUNT_MASK) == 0) {
+            stack.push_back(n);
+        }
+    }
+    drainZeroSpans(cells, stride, stack, reveal);
+    return hit;
+}
+
+// Move a mine between two playable cells, updating only the counts of
+// the two neighborhoods (border counts are never read, so skip them) and
+// its entry in mineCells
+inline void relocateMine(uint8_t* cells, const int* offsets, int* mineCells, int mineCount, int from, int to) {
+    cells[from] &= ~MINE_BIT;
+    cells[to] |= MINE_BIT;
+    for (int k = 0; k < 8; k++) {
+        if (!(cells[from + offsets[k]] & BORDER_BIT)) cells[from + offsets[k]]--;
+        if (!(cells[to + offsets[k]] & BORDER_BIT)) cells[to + offsets[k]]++;
+    }
+    for (int m = 0; m < mineCount; m++) {
+        if (mineCells[m] == from) {
+            mineCells[m] = to;
+            break;
+        }
+    }
+}
+
+// Safe start on a placed board: move any mine out of the clicked cell's
+// 3x3 neighborhood (just the cell itself when the board is too full) to a
+// random free cell outside it. relocate(from, to) moves the mine bit and
+// does the caller's bookkeeping; the draws depend only on the mine bits,
+// so every caller gets the same layout for the same rng state.
+template <typename Relocate>
+inline void clearStartZone(uint8_t* cells, int rows, int cols, const int* offsets, int clicked,
+                           int mineCount, Xoshiro256& rng, Relocate relocate) {
+    int stride = cols + 2;
+    int zone[9];
+    int zoneSize = 0;
+    zone[zoneSize++] = clicked;
+    for (int k = 0; k < 8; k++) {
+        if (!(cells[clicked + offsets[k]] & BORDER_BIT)) zone[zoneSize++] = clicked + offsets[k];
+    }
+    if (mineCount > rows * cols - zoneSize) {
+        zoneSize = 1;
+    }
+    auto inZone = [&](int idx) {
+        for (int z = 0; z < zoneSize; z++) {
+            if (zone[z] == idx) return true;
+        }
+        return false;
+    };
+    
+    for (int z = 0; z < zoneSize; z++) {
+        if (!(cells[zone[z]] & MINE_BIT)) continue;
+        // Random free cell outside the zone; one always exists
+        int target;
+        do {
+            int k = (int)rng.nextBelow((uint32_t)(rows * cols));
+            target = (k / cols + 1) * stride + k % cols + 1;
+        } while ((cells[target] & MINE_BIT) || inZone(target));
+        relocate(zone[z], target);
+    }
+}
+
+// The same on a numbered board, fixing up counts and mineCells locally
+inline void clearStartZone(uint8_t* cells, int rows, int cols, const int* offsets, int clicked,
+                           int* mineCells, int mineCount, Xoshiro256& rng) {
+    clearStartZone(cells, rows, cols, offsets, clicked, mineCount, rng, [&](int from, int to) {
+        relocateMine(cells, offsets, mineCells, mineCount, from, to);
+    });
+}
+
+// Mines under a flag, for the stats after a deferred placement
+inline int countFlaggedMines(const uint8_t* cells, const int* mineCells, int mineCount) {
+    int flagged = 0;
+    for (int m = 0; m < mineCount; m++) {
+        flagged += (cells[mineCells[m]] & (MINE_BIT | FLAGGED_BIT)) == (MINE_BIT | FLAGGED_BIT);
+    }
+    return flagged;
+}
+
+// DSA: 3BV (Bechtel's Board Benchmark Value) - the fewest clicks that clear
+// a numbered board: one per opening (8-connected region of zero cells) plus
+// one per safe number touching no zero. A single raster pass labels zero
+// cells with union-find over two rows of labels instead of flood filling
+// each opening; parent and rowLabels are scratch reused across boards.
+inline int countBoardValue(const uint8_t* cells, int rows, int cols, vector<int>& parent, vector<int>& rowLabels) {
+    int stride = cols + 2;
+    parent.clear();
+    rowLabels.assign(2 * (size_t)stride, -1);
+    auto find = [&](int label) {
+        while (parent[label] != label) label = parent[label] = parent[parent[label]];
+        return label;
+    };
+    auto isZero = [&](int idx) { return (cells[idx] & (COUNT_MASK | MINE_BIT | BORDER_BIT)) == 0; };
+    
+    int openings = 0, isolated = 0;
+    for (int i = 1; i <= rows; i++) {
+        int* above = rowLabels.data() + ((i - 1) & 1) * stride;
+        int* here = rowLabels.data() + (i & 1) * stride;
+        int base = i * stride;
+        for (int j = 1; j <= cols; j++) {
+            uint8_t cell = cells[base + j];
+            here[j] = -1;
+            if (cell & MINE_BIT) continue;
+            if (cell & COUNT_MASK) {
+                bool touchesZero = false;
+                for (int idx = base + j - stride - 1; idx <= base + j + stride - 1 && !touchesZero; idx += stride) {
+                    touchesZero = isZero(idx) || isZero(idx + 1) || isZero(idx + 2);
+                }
+                isolated += !touchesZero;
+                continue;
+            }
+            int label = here[j - 1];
+            if (label < 0) {
+                label = (int)parent.size();
+                parent.push_back(label);
+                openings++;
+            }
+            here[j] = label;
+            for (int k = j - 1; k <= j + 1; k++) {
+                if (above[k] < 0) continue;
+                int a = find(above[k]), b = find(label);
+                if (a != b) {
+                    parent[a] = b;
+                    openings--;
+                }
+            }
+        }
+    }
+    return openings + isolated;
+}
+
+// Add the one-bit value in every lane of `carry` to a 4-bit counter kept
+// as bit-slices c0..c3 (ripple-carry across the slices)
+inline void addSliced(uint64_t& c0, uint64_t& c1, uint64_t& c2, uint64_t& c3, uint64_t carry) {
+    uint64_t t;
+    t = c0 & carry; c0 ^= carry; carry = t;
+    t = c1 & carry; c1 ^= carry; carry = t;
+    t = c2 & carry; c2 ^= carry; carry = t;
+    c3 ^= carry;
+}
+
+// DSA: Bitboard backend for boards up to 32 x 64 (all standard presets).
+// Each plane holds one 64-bit word per row, bit j = column j. Neighbor
+// counts come from bit-sliced adders over shifted planes, flood fill from
+// repeated dilation masked by the zero cells, and win checks from popcount.
+// Generation draws the same Floyd sequence as Minesweeper, so equal seeds
+// give equal boards.
+class BitBoard {
+public:
+    static const int MAX_ROWS = 32;
+    static const int MAX_COLS = 64;
+    
 private:
     int rows, cols, totalMines;
-    vector<vector<int>> grid;        // -1 = mine, 0-8 = number of adjacent mines
-    vector<vector<bool>> revealed;   // track revealed cells
-    vector<vector<bool>> flagged;    // track flagged cells
+    uint64_t colMask;                 // the cols low bits
+    uint64_t mine[MAX_ROWS];
+    uint64_t revealed[MAX_ROWS];
+    uint64_t flagged[MAX_ROWS];
+    uint64_t count[4][MAX_ROWS];      // bit-sliced adjacent mine counts
+    uint64_t zero[MAX_ROWS];          // safe cells with no adjacent mines
     bool gameOver;
-    bool gameWon;
     
-    // Directions for 8 adjacent cells (including diagonals)
-    int dx[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
-    int dy[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+    // Plane rows shifted so bit j holds the left / right neighbor of j
+    uint64_t fromLeft(uint64_t row) const { return (row << 1) & colMask; }
+    uint64_t fromRight(uint64_t row) const { return row >> 1; }
+    
+    // 3x3 dilation of one row given its neighbors above and below
+    uint64_t dilate(uint64_t up, uint64_t mid, uint64_t down) const {
+        uint64_t column = up | mid | down;
+        return (column | fromLeft(column) | fromRight(column)) & colMask;
+    }
+    
+public:
+    BitBoard(int r, int c, int mines) : rows(r), cols(c), totalMines(mines), gameOver(false) {
+        colMask = cols == 64 ? ~0ULL : (1ULL << cols) - 1;
+        clear();
+    }
+    
+    static bool fits(int r, int c) { return r > 0 && c > 0 && r <= MAX_ROWS && c <= MAX_COLS; }
+    
+    // Only the first `rows` words of each plane are ever used
+    void clear() {
+        size_t used = sizeof(uint64_t) * rows;
+        memset(mine, 0, used);
+        memset(revealed, 0, used);
+        memset(flagged, 0, used);
+        memset(zero, 0, used);
+        for (int b = 0; b < 4; b++) memset(count[b], 0, used);
+        gameOver = false;
+    }
+    
+    // Same sampling as placeMinesFloyd, with bits instead of bytes
+    void placeMines(Xoshiro256& rng) {
+        int totalCells = rows * cols;
+        for (int j = totalCells - totalMines; j < totalCells; j++) {
+            int k = (int)rng.nextBelow((uint32_t)j + 1);
+            if (mine[k / cols] >> (k % cols) & 1) k = j;
+            mine[k / cols] |= 1ULL << (k % cols);
+        }
+    }
+    
+    // Sum the 8 shifted neighbor planes of every row with bit-sliced adders
+    void calculateNumbers() {
+        for (int i = 0; i < rows; i++) {
+            uint64_t up = i > 0 ? mine[i - 1] : 0;
+            uint64_t down = i + 1 < rows ? mine[i + 1] : 0;
+            uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+            const uint64_t inputs[8] = {fromLeft(up), up, fromRight(up), fromLeft(mine[i]),
+                                        fromRight(mine[i]), fromLeft(down), down, fromRight(down)};
+            for (int k = 0; k < 8; k++) {
+                addSliced(c0, c1, c2, c3, inputs[k]);
+            }
+            count[0][i] = c0; count[1][i] = c1; count[2][i] = c2; count[3][i] = c3;
+            zero[i] = ~(c0 | c1 | c2 | c3) & ~mine[i] & colMask;
+        }
+    }
+    
+    void generate(uint64_t seed) {
+        Xoshiro256 rng(seed);
+        clear();
+        placeMines(rng);
+        calculateNumbers();
+    }
+    
+    // Reveal a cell; zero cells grow the revealed region by dilating the
+    // newly opened zeros until no unflagged cell is added. Returns the
+    // number of cells revealed.
+    int revealCell(int x, int y) {
+        uint64_t bit = 1ULL << y;
+        if ((revealed[x] | flagged[x]) & bit) return 0;
+        revealed[x] |= bit;
+        if (mine[x] & bit) {
+            gameOver = true;
+            return 1;
+        }
+        if (!(zero[x] & bit)) return 1;
+        
+        int added = 1;
+        uint64_t fresh[MAX_ROWS] = {0};   // zero cells opened in the last step
+        fresh[x] = bit;
+        int top = x, bottom = x;          // rows that may hold fresh zeros
+        while (top <= bottom) {
+            uint64_t grown[MAX_ROWS];
+            int lo = max(0, top - 1), hi = min(rows - 1, bottom + 1);
+            for (int i = lo; i <= hi; i++) {
+                uint64_t up = i > 0 ? fresh[i - 1] : 0;
+                uint64_t down = i + 1 < rows ? fresh[i + 1] : 0;
+                grown[i] = dilate(up, fresh[i], down) & ~revealed[i] & ~flagged[i];
+            }
+            int nextTop = rows, nextBottom = -1;
+            for (int i = lo; i <= hi; i++) {
+                revealed[i] |= grown[i];
+                added += popcount64(grown[i]);
+                fresh[i] = grown[i] & zero[i];
+                if (fresh[i]) {
+                    nextTop = min(nextTop, i);
+                    nextBottom = max(nextBottom, i);
+                }
+            }
+            top = nextTop;
+            bottom = nextBottom;
+        }
+        return added;
+    }
+    
+    void toggleFlag(int x, int y) {
+        uint64_t bit = 1ULL << y;
+        if (!(revealed[x] & bit)) flagged[x] ^= bit;
+    }
+    
+    // Win: every safe cell revealed, by popcount over the rows
+    bool checkWin() const {
+        int safeRevealed = 0;
+        for (int i = 0; i < rows; i++) {
+            safeRevealed += popcount64(revealed[i] & ~mine[i]);
+        }
+        return safeRevealed == rows * cols - totalMines;
+    }
+    
+    int revealedCount() const {
+        int total = 0;
+        for (int i = 0; i < rows; i++) total += popcount64(revealed[i]);
+        return total;
+    }
+    
+    bool isGameOver() const { return gameOver; }
+    bool isMine(int x, int y) const { return mine[x] >> y & 1; }
+    bool isRevealed(int x, int y) const { return revealed[x] >> y & 1; }
+    bool isFlagged(int x, int y) const { return flagged[x] >> y & 1; }
+    int adjacentMines(int x, int y) const {
+        return (int)((count[0][x] >> y & 1) | (count[1][x] >> y & 1) << 1
+                   | (count[2][x] >> y & 1) << 2 | (count[3][x] >> y & 1) << 3);
+    }
+};
+
+class Frontier;
+
+// Read-only view of a padded board, shared by the renderers
+struct BoardView {
+    int rows, cols, stride;
+    const uint8_t* cells;
+    const Frontier* frontier = nullptr;   // set when the owner tracks one
+    
+    int index(int x, int y) const { return (x + 1) * stride + (y + 1); }
+};
+
+// DSA: Incremental frontier - the hidden cells next to at least one revealed
+// safe cell (a number, or a zero whose neighbor is flagged), kept as an
+// indexed set: a dense list plus each cell's position in it. The other
+// hidden cells, the interior, are kept the same way in three lists:
+// corners, edges and the rest, so a guess can start where an opening is
+// likeliest. Alongside,
+// numbersAround counts every cell's revealed safe neighbors and
+// unknownAround counts each revealed safe cell's hidden, unflagged neighbors.
+// The owner reports every reveal, hide and flag change right after it
+// flips the bit, and only that cell's 8 neighbors are touched.
+class Frontier {
+private:
+    int offsets[8];
+    vector<int> members;
+    vector<int> position;            // index in members, -1 if absent
+    vector<int> interior[3];         // hidden cells next to no revealed safe cell, by placeOf
+    vector<int> interiorPosition;    // index in its interior list, -1 if absent
+    vector<uint8_t> numbersAround;
+    vector<uint8_t> unknownAround;
+    int hiddenCells;                 // playable cells not yet revealed
+    int revealedMines;
+    
+    static bool isSafeRevealed(uint8_t cell) {
+        return (cell & (REVEALED_BIT | BORDER_BIT | MINE_BIT)) == REVEALED_BIT;
+    }
+    
+    static void insert(vector<int>& list, vector<int>& at, int idx) {
+        if (at[idx] >= 0) return;
+        at[idx] = (int)list.size();
+        list.push_back(idx);
+    }
+    
+    static void erase(vector<int>& list, vector<int>& at, int idx) {
+        if (at[idx] < 0) return;
+        int last = list.back();
+        list[at[idx]] = last;
+        at[last] = at[idx];
+        list.pop_back();
+        at[idx] = -1;
+    }
+    
+    // 0 for a corner, 1 for an edge, 2 for any other cell
+    int placeOf(const uint8_t* cells, int idx) const {
+        int border = 0;
+        for (int k = 0; k < 8; k++) border += (cells[idx + offsets[k]] & BORDER_BIT) != 0;
+        return border >= 5 ? 0 : border >= 3 ? 1 : 2;
+    }
+    
+    // Hidden cell idx joins the frontier (or the interior, once no
+    // revealed safe cell is left next to it)
+    void toFrontier(const uint8_t* cells, int idx) {
+        erase(interior[placeOf(cells, idx)], interiorPosition, idx);
+        insert(members, position, idx);
+    }
+    
+    void toInterior(const uint8_t* cells, int idx) {
+        erase(members, position, idx);
+        insert(interior[placeOf(cells, idx)], interiorPosition, idx);
+    }
     
 public:
-    Minesweeper(int r, int c, int mines) : rows(r), cols(c), totalMines(mines) {
-        // Initialize 2D vectors
-        grid.resize(rows, vector<int>(cols, 0));
-        revealed.resize(rows, vector<bool>(cols, false));
-        flagged.resize(rows, vector<bool>(cols, false));
+    Frontier() : hiddenCells(0), revealedMines(0) {}
+    
+    // Rebuild from scratch for the board in view (O(cells))
+    void attach(const BoardView& view) {
+        int stride = view.stride;
+        int k = 0;
+        for (int dx = -1; dx <= 1; dx++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                if (dx != 0 || dy != 0) offsets[k++] = dx * stride + dy;
+            }
+        }
+        size_t total = boardBytes(view.rows, view.cols);
+        members.clear();
+        position.assign(total, -1);
+        for (vector<int>& list : interior) list.clear();
+        interiorPosition.assign(total, -1);
+        numbersAround.assign(total, 0);
+        unknownAround.assign(total, 0);
+        hiddenCells = revealedMines = 0;
+        for (int i = 0; i < view.rows; i++) {
+            for (int j = 0; j < view.cols; j++) {
+                int idx = view.index(i, j);
+                uint8_t cell = view.cells[idx];
+                if (!(cell & REVEALED_BIT)) {
+                    hiddenCells++;
+                } else if (cell & MINE_BIT) {
+                    revealedMines++;
+                }
+                for (int n = 0; n < 8; n++) {
+                    uint8_t neighbor = view.cells[idx + offsets[n]];
+                    numbersAround[idx] += isSafeRevealed(neighbor);
+                    if (isSafeRevealed(cell) && !(neighbor & (REVEALED_BIT | FLAGGED_BIT))) {
+                        unknownAround[idx]++;
+                    }
+                }
+                if (!(cell & REVEALED_BIT)) {
+                    if (numbersAround[idx] > 0) toFrontier(view.cells, idx);
+                    else toInterior(view.cells, idx);
+                }
+            }
+        }
+    }
+    
+    // idx was just revealed
+    void revealed(const uint8_t* cells, int idx) {
+        bool safe = !(cells[idx] & MINE_BIT);
+        bool flagged = cells[idx] & FLAGGED_BIT;
+        int hidden = 0;
+        for (int k = 0; k < 8; k++) {
+            int n = idx + offsets[k];
+            uint8_t neighbor = cells[n];
+            if (!(neighbor & REVEALED_BIT)) {
+                hidden += !(neighbor & FLAGGED_BIT);
+                if (safe && ++numbersAround[n] == 1) toFrontier(cells, n);
+            } else {
+                numbersAround[n] += safe;
+                if (!flagged && isSafeRevealed(neighbor)) unknownAround[n]--;
+            }
+        }
+        unknownAround[idx] = safe ? (uint8_t)hidden : 0;
+        erase(members, position, idx);
+        erase(interior[placeOf(cells, idx)], interiorPosition, idx);
+        hiddenCells--;
+        revealedMines += !safe;
+    }
+    
+    // idx was just hidden again (undo)
+    void hidden(const uint8_t* cells, int idx) {
+        bool safe = !(cells[idx] & MINE_BIT);
+        bool flagged = cells[idx] & FLAGGED_BIT;
+        for (int k = 0; k < 8; k++) {
+            int n = idx + offsets[k];
+            uint8_t neighbor = cells[n];
+            numbersAround[n] -= safe;
+            if (!(neighbor & REVEALED_BIT)) {
+                if (safe && numbersAround[n] == 0) toInterior(cells, n);
+            } else if (!flagged && isSafeRevealed(neighbor)) {
+                unknownAround[n]++;
+            }
+        }
+        unknownAround[idx] = 0;
+        if (numbersAround[idx] > 0) toFrontier(cells, idx);
+        else toInterior(cells, idx);
+        hiddenCells++;
+        revealedMines -= !safe;
+    }
+    
+    // The flag on hidden cell idx was just toggled
+    void flagChanged(const uint8_t* cells, int idx) {
+        int delta = (cells[idx] & FLAGGED_BIT) ? -1 : 1;
+        for (int k = 0; k < 8; k++) {
+            int n = idx + offsets[k];
+            if (isSafeRevealed(cells[n])) unknownAround[n] += delta;
+        }
+    }
+    
+    const vector<int>& cells() const { return members; }
+    bool contains(int idx) const { return position[idx] >= 0; }
+    
+    // An interior cell, corners first, then edges; -1 if there is none
+    int interiorCell() const {
+        for (const vector<int>& list : interior) {
+            if (!list.empty()) return list.back();
+        }
+        return -1;
+    }
+    int remainingAround(int idx) const { return unknownAround[idx]; }
+    int getHiddenCells() const { return hiddenCells; }
+    int getRevealedMines() const { return revealedMines; }
+};
+
+// DSA: Arena of many same-sized boards in one contiguous allocation.
+// Board i lives at boardBytes(rows, cols) * i and was generated from
+// seedOf(i) = streamSeed(baseSeed, i).
+class BoardArena {
+private:
+    int rows, cols, mines;
+    uint64_t baseSeed;
+    size_t count;
+    size_t bytesPerBoard;
+    unique_ptr<uint8_t[]> storage;   // left uninitialized until generated
+    
+public:
+    BoardArena(int r, int c, int m, size_t boards, uint64_t seed)
+        : rows(r), cols(c), mines(m), baseSeed(seed), count(boards),
+          bytesPerBoard(boardBytes(r, c)), storage(new uint8_t[boardBytes(r, c) * boards]) {}
+    
+    size_t size() const { return count; }
+    size_t boardSize() const { return bytesPerBoard; }
+    uint64_t seedOf(size_t i) const { return streamSeed(baseSeed, i); }
+    uint8_t* board(size_t i) { return storage.get() + bytesPerBoard * i; }
+    const uint8_t* data() const { return storage.get(); }
+    BoardView view(size_t i) const {
+        return BoardView{rows, cols, cols + 2, storage.get() + bytesPerBoard * i};
+    }
+    
+    // Generate every board on a pool of worker threads. Workers claim
+    // chunks of boards from a shared counter; each board is seeded from
+    // its own index, so the output is identical for any thread count.
+    void generate(int threads) {
+        const size_t CHUNK = 64;
+        atomic<size_t> nextChunk(0);
+        auto worker = [&]() {
+            Xoshiro256 rng;
+            vector<int> mineCells;
+            while (true) {
+                size_t first = nextChunk.fetch_add(CHUNK);
+                if (first >= count) break;
+                size_t last = min(count, first + CHUNK);
+                for (size_t i = first; i < last; i++) {
+                    uint8_t* cells = board(i);
+                    rng.reseed(seedOf(i));
+                    mineCells.clear();
+                    initBoardCells(cells, rows, cols);
+                    placeMinesFloyd(cells, rows, cols, mines, rng, mineCells);
+                    numberBoard(cells, rows, cols, mineCells);
+                }
+            }
+        };
+        
+        vector<thread> pool;
+        for (int t = 1; t < threads; t++) {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (thread& t : pool) {
+            t.join();
+        }
+    }
+};
+
+// DSA: Lockstep batch simulator. LANES boards are laid out structure-of-
+// arrays: every plane holds one 64-bit word per padded cell, bit k = board
+// k, so each word operation advances all boards at once. Numbering and
+// the bot's deductions run on bit-sliced adders, and flood fill is a
+// search whose queued cells carry the lanes still spreading; only dealing
+// and guessing touch one board at a time. Board k of a batch starting at
+// game g is the board Minesweeper deals for streamSeed(seed, g + k), and
+// every game opens at the center.
+class LockstepSimulator {
+public:
+    static const int LANES = 64;
+    
+    struct Result {
+        int moves = 0;       // cells clicked, the opening click included
+        int guesses = 0;     // clicks no deduction backed
+        bool won = false;
+    };
+    
+private:
+    int rows, cols, totalMines, stride;
+    StartMode start;
+    int offsets[8];
+    vector<int> playable;               // board index of every playable cell
+    vector<uint64_t> mine, revealed, flagged, zero;
+    vector<uint64_t> count[4];          // bit-sliced adjacent mine counts
+    vector<uint64_t> click, spreading;  // per cell: lanes to click, lanes to flood from
+    vector<int> clicked, pending;       // cells whose click / spreading word is nonzero
+    vector<uint8_t> laneCells;          // one board, dealt byte-wise
+    vector<int> mineCells;
+    Xoshiro256 rng;
+    
+    static uint64_t equal4(const uint64_t a[4], const uint64_t b[4]) {
+        return ~((a[0] ^ b[0]) | (a[1] ^ b[1]) | (a[2] ^ b[2]) | (a[3] ^ b[3]));
+    }
+    
+    // Bit-sliced a + b; the sums used here never exceed 8
+    static void add4(const uint64_t a[4], const uint64_t b[4], uint64_t sum[4]) {
+        uint64_t carry = 0;
+        for (int s = 0; s < 4; s++) {
+            sum[s] = a[s] ^ b[s] ^ carry;
+            carry = (a[s] & b[s]) | (carry & (a[s] ^ b[s]));
+        }
+    }
+    
+    int openingCell() const { return (rows / 2 + 1) * stride + cols / 2 + 1; }
+    
+    void queueClick(int idx, uint64_t lanes) {
+        if (!lanes) return;
+        if (!click[idx]) clicked.push_back(idx);
+        click[idx] |= lanes;
+    }
+    
+    void spread(int idx, uint64_t lanes) {
+        if (!lanes) return;
+        if (!spreading[idx]) pending.push_back(idx);
+        spreading[idx] |= lanes;
+    }
+    
+    // Deal one board byte-wise and transpose its mines into the lane's bit
+    void dealLane(int lane, uint64_t boardSeed, int opening) {
+        uint8_t* cells = laneCells.data();
+        initBoardCells(cells, rows, cols);
+        rng.reseed(boardSeed);
+        mineCells.clear();
+        placeMinesFloyd(cells, rows, cols, totalMines, rng, mineCells);
+        if (start != START_ANYWHERE) {
+            // Minesweeper::generateAround's draws; the lanes are numbered later
+            clearStartZone(cells, rows, cols, offsets, opening, totalMines, rng, [cells](int from, int to) {
+                cells[from] &= ~MINE_BIT;
+                cells[to] |= MINE_BIT;
+            });
+        }
+        uint64_t bit = 1ULL << lane;
+        for (int idx : playable) {
+            if (cells[idx] & MINE_BIT) mine[idx] |= bit;
+        }
+    }
+    
+    // Count the 8 neighbor mine words of every cell, all lanes at once
+    void number() {
+        for (int idx : playable) {
+            uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+            for (int k = 0; k < 8; k++) {
+                addSliced(c0, c1, c2, c3, mine[idx + offsets[k]]);
+            }
+            count[0][idx] = c0; count[1][idx] = c1; count[2][idx] = c2; count[3][idx] = c3;
+            zero[idx] = ~(c0 | c1 | c2 | c3) & ~mine[idx];
+        }
+    }
+    
+    // Reveal every queued click, then grow the regions of zero cells. A
+    // cell is queued again only when new lanes reach it.
+    uint64_t revealClicks(Result* results) {
+        uint64_t lost = 0;
+        for (int idx : clicked) {
+            uint64_t lanes = click[idx];
+            click[idx] = 0;
+            for (uint64_t rest = lanes; rest; rest &= rest - 1) {
+                results[lowestBit64(rest)].moves++;
+            }
+            revealed[idx] |= lanes;
+            lost |= lanes & mine[idx];
+            spread(idx, lanes & zero[idx]);
+        }
+        clicked.clear();
+        
+        while (!pending.empty()) {
+            int idx = pending.back();
+            pending.pop_back();
+            uint64_t lanes = spreading[idx];
+            spreading[idx] = 0;
+            for (int k = 0; k < 8; k++) {
+                int n = idx + offsets[k];
+                uint64_t opened = lanes & ~revealed[n] & ~flagged[n];
+                revealed[n] |= opened;
+                spread(n, opened & zero[n]);
+            }
+        }
+        return lost;
+    }
+    
+    // Single-cell rules on every number of the active lanes: flags equal to
+    // the count clear the other hidden neighbors, flags plus hidden equal to
+    // it flag them all. Flags apply at once (they are always right), clicks
+    // wait for the next round. Returns the lanes that made progress.
+    uint64_t deduce(uint64_t active) {
+        uint64_t progress = 0;
+        for (int idx : playable) {
+            uint64_t number = revealed[idx] & ~mine[idx] & active;
+            if (!number) continue;
+            uint64_t hidden[8];
+            uint64_t anyHidden = 0;
+            for (int k = 0; k < 8; k++) {
+                int n = idx + offsets[k];
+                hidden[k] = ~revealed[n] & ~flagged[n];
+                anyHidden |= hidden[k];
+            }
+            number &= anyHidden;
+            if (!number) continue;
+            
+            uint64_t h[4] = {0, 0, 0, 0}, f[4] = {0, 0, 0, 0}, total[4];
+            for (int k = 0; k < 8; k++) {
+                addSliced(h[0], h[1], h[2], h[3], hidden[k]);
+                addSliced(f[0], f[1], f[2], f[3], flagged[idx + offsets[k]]);
+            }
+            add4(h, f, total);
+            uint64_t c[4] = {count[0][idx], count[1][idx], count[2][idx], count[3][idx]};
+            uint64_t safe = number & equal4(c, f);
+            uint64_t mines = number & ~safe & equal4(c, total);
+            if (!(safe | mines)) continue;
+            progress |= safe | mines;
+            for (int k = 0; k < 8; k++) {
+                int n = idx + offsets[k];
+                queueClick(n, safe & hidden[k]);
+                flagged[n] |= mines & hidden[k];
+            }
+        }
+        return progress;
+    }
+    
+    // Click a uniformly random hidden, unflagged cell of one board: a few
+    // random probes first, a reservoir scan once the board is mostly open
+    void guess(int lane) {
+        uint64_t bit = 1ULL << lane;
+        for (int tries = 0; tries < 16; tries++) {
+            int idx = playable[rng.nextBelow((uint32_t)playable.size())];
+            if (!((revealed[idx] | flagged[idx]) & bit)) {
+                queueClick(idx, bit);
+                return;
+            }
+        }
+        uint32_t candidates = 0;
+        int chosen = -1;
+        for (int idx : playable) {
+            if (!((revealed[idx] | flagged[idx]) & bit) && rng.nextBelow(++candidates) == 0) chosen = idx;
+        }
+        queueClick(chosen, bit);
+    }
+    
+public:
+    LockstepSimulator(int r, int c, int mines, StartMode startMode)
+        : rows(r), cols(c), totalMines(mines), stride(c + 2), start(startMode), laneCells(boardBytes(r, c)) {
+        int k = 0;
+        for (int dx = -1; dx <= 1; dx++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                if (dx != 0 || dy != 0) offsets[k++] = dx * stride + dy;
+            }
+        }
+        size_t total = boardBytes(r, c);
+        for (vector<uint64_t>* plane : {&mine, &revealed, &flagged, &zero, &click, &spreading}) {
+            plane->assign(total, 0);
+        }
+        for (int b = 0; b < 4; b++) count[b].assign(total, 0);
+        playable.reserve((size_t)r * c);
+        for (int i = 1; i <= r; i++) {
+            for (int j = 1; j <= c; j++) playable.push_back(i * stride + j);
+        }
+    }
+    
+    // Deal and number games first .. first + n - 1 (n <= LANES), unopened
+    void begin(uint64_t seed, long long first, int n) {
+        fill(mine.begin(), mine.end(), 0);
+        fill(flagged.begin(), flagged.end(), 0);
+        fill(revealed.begin(), revealed.end(), ~0ULL);   // the border stays revealed
+        for (int idx : playable) revealed[idx] = 0;
+        for (int lane = 0; lane < n; lane++) {
+            dealLane(lane, streamSeed(seed, first + lane), openingCell());
+        }
+        number();
+    }
+    
+    // Play games first .. first + n - 1 (n <= LANES) to the end in lockstep;
+    // every round reveals the clicks queued by the last one, then deduces
+    // or guesses the next clicks of each board still playing
+    void play(uint64_t seed, long long first, int n, Result* results) {
+        uint64_t active = n == LANES ? ~0ULL : (1ULL << n) - 1;
+        begin(seed, first, n);
+        for (int lane = 0; lane < n; lane++) results[lane] = Result();
+        rng.reseed(streamSeed(seed ^ 0x5DEECE66DULL, first));
+        
+        int opening = openingCell();
+        queueClick(opening, active);
+        while (true) {
+            uint64_t lost = revealClicks(results);
+            uint64_t unfinished = 0;
+            for (int idx : playable) unfinished |= ~revealed[idx] & ~mine[idx];
+            uint64_t won = active & ~lost & ~unfinished;
+            for (uint64_t rest = won; rest; rest &= rest - 1) {
+                results[lowestBit64(rest)].won = true;
+            }
+            active &= ~(lost | won);
+            if (!active) break;
+            
+            for (uint64_t stuck = active & ~deduce(active); stuck; stuck &= stuck - 1) {
+                int lane = lowestBit64(stuck);
+                guess(lane);
+                results[lane].guesses++;
+            }
+        }
+    }
+    
+    // Cell (x, y) of board `lane` in the Minesweeper cell encoding
+    uint8_t cellOf(int lane, int x, int y) const {
+        int idx = (x + 1) * stride + y + 1;
+        int adjacent = 0;
+        for (int b = 0; b < 4; b++) adjacent |= (int)(count[b][idx] >> lane & 1) << b;
+        return (uint8_t)(adjacent | (mine[idx] >> lane & 1 ? MINE_BIT : 0) | (revealed[idx] >> lane & 1 ? REVEALED_BIT : 0)
+                         | (flagged[idx] >> lane & 1 ? FLAGGED_BIT : 0));
+    }
+};
+
+// Buffered terminal renderer: every frame is formatted into one reusable
+// buffer and written with a single call. On ANSI terminals, frames after
+// the first only redraw the cells changed by the last move, and boards
+// larger than the terminal are shown through a scrollable viewport.
+class TerminalRenderer {
+private:
+    string frame;            // output buffer, reused between frames
+    bool ansi;               // cursor addressing available
+    bool synced;             // screen matches the board except for new changes
+    int viewRow, viewCol;    // top-left board cell of the viewport
+    int viewRows, viewCols;  // viewport size in cells
+    int labelWidth;          // width of the row labels
+    long long labelRow;      // board coordinates printed for cell (0, 0)
+    long long labelCol;
+    
+    static int digits(int value) {
+        int count = 1;
+        while (value >= 10) { value /= 10; count++; }
+        return count;
+    }
+    
+    void appendNumber(long long value, int width) {
+        char text[24];
+        int len = snprintf(text, sizeof(text), "%lld", value);
+        if (len < width) frame.append(width - len, ' ');
+        frame.append(text, len);
+    }
+    
+    void appendCell(uint8_t cell, bool showMines) {
+        if ((cell & FLAGGED_BIT) && !showMines) {
+            frame += " F ";
+        } else if (!(cell & REVEALED_BIT) && !showMines) {
+            frame += " . ";
+        } else if (cell & MINE_BIT) {
+            frame += " * ";
+        } else if ((cell & COUNT_MASK) == 0) {
+            frame += "   ";
+        } else {
+            frame += ' ';
+            frame += (char)('0' + (cell & COUNT_MASK));
+            frame += ' ';
+        }
+    }
+    
+    void moveCursor(int screenRow, int screenCol) {
+        frame += "\x1b[";
+        appendNumber(screenRow, 0);
+        frame += ';';
+        appendNumber(screenCol, 0);
+        frame += 'H';
+    }
+    
+    // Screen line of the status block: blank line, header, rows, blank line
+    int statusRow() const { return viewRows + 4; }
+    
+    void flush() {
+        cout.write(frame.data(), (streamsize)frame.size());
+        cout.flush();
+    }
+    
+public:
+    TerminalRenderer() : ansi(false), synced(false), viewRow(0), viewCol(0),
+                         viewRows(0), viewCols(0), labelWidth(2), labelRow(0), labelCol(0) {
+#if defined(__unix__) || defined(__APPLE__)
+        const char* term = getenv("TERM");
+        ansi = isatty(STDOUT_FILENO) && term && string(term) != "dumb";
+#endif
+    }
+    
+    // Size the viewport for a board, limited by the terminal when known
+    void attach(int rows, int cols) {
+        labelWidth = max(2, digits(rows - 1));
+        viewRows = rows;
+        viewCols = cols;
+        viewRow = viewCol = 0;
+#if defined(__unix__) || defined(__APPLE__)
+        struct winsize size;
+        if (ansi && ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0) {
+            viewCols = max(1, min(cols, (size.ws_col - labelWidth - 1) / 3));
+            viewRows = max(1, min(rows, size.ws_row - 7));
+        }
+#endif
+        frame.reserve((size_t)(viewRows + 4) * (labelWidth + 2 + 3 * viewCols) + 256);
+        synced = false;
+    }
+    
+    // Label rows and columns as a window onto a larger board at (row, col)
+    void setLabelOrigin(long long row, long long col) {
+        labelRow = row;
+        labelCol = col;
+        labelWidth = max(2, (int)max(to_string(row).size(), to_string(row + viewRows - 1).size()));
+        synced = false;
+    }
+    
+    bool isAnsi() const { return ansi; }
+    void invalidate() { synced = false; }
+    
+    // Scroll so the viewport starts at (x, y), clamped to the board
+    void scrollTo(const BoardView& board, int x, int y) {
+        viewRow = max(0, min(x, board.rows - viewRows));
+        viewCol = max(0, min(y, board.cols - viewCols));
+        synced = false;
+    }
+    
+    // Scroll the minimum distance needed to bring (x, y) into view
+    void ensureVisible(const BoardView& board, int x, int y) {
+        if (x >= viewRow && x < viewRow + viewRows && y >= viewCol && y < viewCol + viewCols) {
+            return;
+        }
+        scrollTo(board, x - viewRows / 2, y - viewCols / 2);
+    }
+    
+    // Format the whole viewport plus the status text and write it at once
+    void drawFull(const BoardView& board, bool showMines, const string& status) {
+        MS_TIMED(RENDER);
+        if (viewRows == 0) attach(board.rows, board.cols);
+        frame.clear();
+        if (ansi) frame += "\x1b[H\x1b[2J";
+        frame += '\n';
+        frame.append(labelWidth + 1, ' ');
+        for (int j = viewCol; j < viewCol + viewCols; j++) {
+            // Wide column coordinates keep only their last two digits
+            long long label = labelCol + j;
+            if (label < -99 || label > 999) label = (label < 0 ? -label : label) % 100;
+            appendNumber(label, 3);
+        }
+        frame += '\n';
+        
+        for (int i = viewRow; i < viewRow + viewRows; i++) {
+            appendNumber(labelRow + i, labelWidth);
+            frame += ' ';
+            const uint8_t* row = board.cells + board.index(i, viewCol);
+            for (int j = 0; j < viewCols; j++) {
+                appendCell(row[j], showMines);
+            }
+            frame += '\n';
+        }
+        frame += '\n';
+        frame += status;
+        MS_RECORD_SIZE(RENDER, frame.size());
+        flush();
+        synced = ansi && !showMines;
+    }
+    
+    // Redraw only the changed cells (board indices) and the status text;
+    // falls back to a full frame when the screen cannot be patched
+    void drawChanges(const BoardView& board, const vector<int>& changed, const string& status) {
+        if (!synced) {
+            drawFull(board, false, status);
+            return;
+        }
+        
+        MS_TIMED(RENDER);
+        frame.clear();
+        for (int idx : changed) {
+            int x = idx / board.stride - 1;
+            int y = idx % board.stride - 1;
+            if (x < viewRow || x >= viewRow + viewRows || y < viewCol || y >= viewCol + viewCols) {
+                continue;
+            }
+            moveCursor(x - viewRow + 3, labelWidth + 2 + 3 * (y - viewCol));
+            appendCell(board.cells[idx], false);
+        }
+        moveCursor(statusRow(), 1);
+        frame += "\x1b[J";
+        frame += status;
+        MS_RECORD_SIZE(RENDER, frame.size());
+        flush();
+    }
+};
+
+// DSA: Exact enumeration of one frontier component by backtracking.
+// Variables are unknown cells, constraints are revealed numbers over them.
+// Solutions are tallied by their mine count k so callers can weight them:
+// solutions[k] and cellMines[v * (vars + 1) + k] (solutions with var v a mine).
+class ComponentEnumerator {
+private:
+    int vars;
+    vector<int> need;                   // per constraint: mines still required
+    vector<int> unassigned;             // per constraint: unassigned vars left
+    vector<int> assignedMines;          // per constraint
+    vector<vector<int>> varConstraints; // constraints touching each var
+    vector<uint8_t> value;              // current assignment
+    long long nodes, nodeBudget;
+    
+    bool assign(int v, int mine) {
+        bool feasible = true;
+        value[v] = (uint8_t)mine;
+        for (int c : varConstraints[v]) {
+            unassigned[c]--;
+            assignedMines[c] += mine;
+            if (assignedMines[c] > need[c] || assignedMines[c] + unassigned[c] < need[c]) {
+                feasible = false;
+            }
+        }
+        return feasible;
+    }
+    
+    void unassign(int v) {
+        for (int c : varConstraints[v]) {
+            unassigned[c]++;
+            assignedMines[c] -= value[v];
+        }
+    }
+    
+    void search(int v, int minesSoFar) {
+        if (++nodes > nodeBudget) return;
+        if (v == vars) {
+            solutions[minesSoFar] += 1;
+            for (int u = 0; u < vars; u++) {
+                if (value[u]) cellMines[(size_t)u * (vars + 1) + minesSoFar] += 1;
+            }
+            return;
+        }
+        for (int mine = 0; mine <= 1; mine++) {
+            if (assign(v, mine)) search(v + 1, minesSoFar + mine);
+            unassign(v);
+        }
+    }
+    
+public:
+    vector<double> solutions;
+    vector<double> cellMines;
+    
+    // constraintVars[c] lists the vars of constraint c; needs[c] its mines.
+    // Returns false if the node budget ran out (results are then partial).
+    bool enumerate(int varCount, const vector<vector<int>>& constraintVars, const vector<int>& needs,
+                   long long budget) {
+        vars = varCount;
+        need = needs;
+        unassigned.assign(needs.size(), 0);
+        assignedMines.assign(needs.size(), 0);
+        varConstraints.assign(vars, vector<int>());
+        for (size_t c = 0; c < constraintVars.size(); c++) {
+            for (int v : constraintVars[c]) {
+                varConstraints[v].push_back((int)c);
+                unassigned[c]++;
+            }
+        }
+        value.assign(vars, 0);
+        solutions.assign(vars + 1, 0.0);
+        cellMines.assign((size_t)vars * (vars + 1), 0.0);
+        nodes = 0;
+        nodeBudget = budget;
+        search(0, 0);
+        return nodes <= nodeBudget;
+    }
+};
+
+// Solver knowledge about a cell, beyond what the board shows
+const uint8_t KNOWN_SAFE = 1;
+const uint8_t KNOWN_MINE = 2;
+
+// DSA: Incremental constraint-propagation solver. It only reads revealed
+// numbers, never hidden mines. Each update re-examines just the numbers
+// whose unknown neighborhoods changed: first the single-cell rules, then
+// pairwise (subset/overlap) reduction between nearby numbers, and exact
+// enumeration of frontier components only when a safe cell is requested
+// and nothing cheaper found one. Player flags are ignored.
+class Solver {
+private:
+    BoardView board;
+    int offsets[8];
+    vector<uint8_t> known;        // KNOWN_SAFE / KNOWN_MINE deductions per cell
+    vector<uint8_t> queued;       // bit 0: in pending, bit 1: in touched
+    vector<int> pending;          // numbers to re-check with the single-cell rules
+    vector<int> touched;          // numbers to try pairwise rules on
+    vector<int> active;           // indexed set of numbers with unknown neighbors
+    vector<int> activePos;        // position in `active`, -1 if absent
+    vector<int> safeList;         // deduced safe cells (some may be revealed since)
+    vector<int> mineList;         // deduced mines
+    size_t safeCursor;
+    ComponentEnumerator enumerator;
+    vector<int> varOf;            // enumeration scratch, -1 outside a run
+    vector<int> constraintOf;
+    
+    bool isNumber(int idx) const {
+        return (board.cells[idx] & (REVEALED_BIT | BORDER_BIT | MINE_BIT)) == REVEALED_BIT;
+    }
+    
+    bool isUnknown(int idx) const {
+        return !(board.cells[idx] & REVEALED_BIT) && !known[idx];
+    }
+    
+    // Unknown neighbors of a number and the mines it still needs
+    int gather(int idx, int* unknown, int& need) const {
+        int count = 0;
+        need = board.cells[idx] & COUNT_MASK;
+        for (int k = 0; k < 8; k++) {
+            int n = idx + offsets[k];
+            if (known[n] == KNOWN_MINE || (board.cells[n] & (REVEALED_BIT | MINE_BIT)) == (REVEALED_BIT | MINE_BIT)) {
+                need--;   // deduced, or detonated
+            } else if (isUnknown(n)) {
+                unknown[count++] = n;
+            }
+        }
+        return count;
+    }
+    
+    void enqueue(int idx) {
+        if (!(queued[idx] & 1)) {
+            queued[idx] |= 1;
+            pending.push_back(idx);
+        }
+    }
+    
+    void setActive(int idx, bool on) {
+        if (on && activePos[idx] < 0) {
+            activePos[idx] = (int)active.size();
+            active.push_back(idx);
+        } else if (!on && activePos[idx] >= 0) {
+            int last = active.back();
+            active[activePos[idx]] = last;
+            activePos[last] = activePos[idx];
+            active.pop_back();
+            activePos[idx] = -1;
+        }
+    }
+    
+    // Record a deduction and requeue every number next to the cell
+    void learn(int idx, uint8_t fact) {
+        if (known[idx]) return;
+        known[idx] = fact;
+        if (fact == KNOWN_SAFE) {
+            safeList.push_back(idx);
+            deductions.safe++;
+        } else {
+            mineList.push_back(idx);
+            deductions.mines++;
+        }
+        for (int k = 0; k < 8; k++) {
+            if (isNumber(idx + offsets[k])) enqueue(idx + offsets[k]);
+        }
+    }
+    
+    // Single-cell rules: all remaining neighbors are safe, or all are mines
+    void checkSingle(int idx) {
+        int unknown[8], need;
+        int count = gather(idx, unknown, need);
+        setActive(idx, count > 0);
+        if (count == 0) return;
+        if (need == 0 || need == count) {
+            for (int i = 0; i < count; i++) learn(unknown[i], need == 0 ? KNOWN_SAFE : KNOWN_MINE);
+        } else if (!(queued[idx] & 2)) {
+            queued[idx] |= 2;
+            touched.push_back(idx);
+        }
+    }
+    
+    // Pairwise rules between a number A and each active number B within
+    // distance 2: if B's unknowns are a subset of A's, the rest of A holds
+    // exactly needA - needB mines; more generally, if A's extra cells must
+    // all be mines to reach needA, B's extra cells are all safe
+    bool checkPairs(int a) {
+        int unknownA[8], needA;
+        int countA = gather(a, unknownA, needA);
+        if (countA == 0) return false;
+        bool progress = false;
+        for (int dx = -2; dx <= 2; dx++) {
+            for (int dy = -2; dy <= 2; dy++) {
+                int b = a + dx * board.stride + dy;
+                if ((dx == 0 && dy == 0) || b < 0 || b >= (int)known.size() || activePos[b] < 0) continue;
+                int unknownB[8], needB;
+                int countB = gather(b, unknownB, needB);
+                
+                int onlyA[8], onlyB[8], nA = 0, nB = 0;
+                for (int i = 0; i < countA; i++) {
+                    bool shared = false;
+                    for (int j = 0; j < countB; j++) shared |= unknownA[i] == unknownB[j];
+                    if (!shared) onlyA[nA++] = unknownA[i];
+                }
+                for (int j = 0; j < countB; j++) {
+                    bool shared = false;
+                    for (int i = 0; i < countA; i++) shared |= unknownA[i] == unknownB[j];
+                    if (!shared) onlyB[nB++] = unknownB[j];
+                }
+                if (nA + nB == countA + countB) continue;   // no overlap
+                
+                if (nB == 0 && nA > 0 && (needA == needB || needA - needB == nA)) {
+                    for (int i = 0; i < nA; i++) learn(onlyA[i], needA == needB ? KNOWN_SAFE : KNOWN_MINE);
+                    progress = true;
+                } else if (nA > 0 && needA - needB == nA) {
+                    for (int i = 0; i < nA; i++) learn(onlyA[i], KNOWN_MINE);
+                    for (int j = 0; j < nB; j++) learn(onlyB[j], KNOWN_SAFE);
+                    progress = true;
+                } else if (nB > 0 && needB - needA == nB) {
+                    for (int j = 0; j < nB; j++) learn(onlyB[j], KNOWN_MINE);
+                    for (int i = 0; i < nA; i++) learn(onlyA[i], KNOWN_SAFE);
+                    progress = true;
+                }
+                if (progress) return true;
+            }
+        }
+        return false;
+    }
+    
+    // Run the cheap rules until nothing more follows
+    void propagate() {
+        while (!pending.empty() || !touched.empty()) {
+            while (!pending.empty()) {
+                int idx = pending.back();
+                pending.pop_back();
+                queued[idx] &= ~1;
+                checkSingle(idx);
+            }
+            while (pending.empty() && !touched.empty()) {
+                int idx = touched.back();
+                touched.pop_back();
+                queued[idx] &= ~2;
+                if (activePos[idx] >= 0 && checkPairs(idx)) deductions.pairwise++;
+            }
+        }
+    }
+    
+    // Exact fallback: split the active numbers into components that share
+    // unknown cells and enumerate each small enough one
+    bool enumerateFrontier() {
+        const int MAX_COMPONENT_CELLS = 48;
+        const long long NODE_BUDGET = 200000;
+        bool progress = false;
+        vector<int> visited;   // cells whose scratch entries must be reset
+        
+        for (size_t root = 0; root < active.size(); root++) {
+            if (constraintOf[active[root]] >= 0) continue;
+            
+            // Breadth-first over numbers and their unknown cells
+            vector<int> numbers(1, active[root]), cellsInComponent;
+            vector<vector<int>> constraintVars;
+            vector<int> needs;
+            constraintOf[active[root]] = 0;
+            visited.push_back(active[root]);
+            for (size_t q = 0; q < numbers.size(); q++) {
+                int unknown[8], need;
+                int count = gather(numbers[q], unknown, need);
+                constraintVars.push_back(vector<int>());
+                needs.push_back(need);
+                for (int i = 0; i < count; i++) {
+                    int cell = unknown[i];
+                    if (varOf[cell] < 0) {
+                        varOf[cell] = (int)cellsInComponent.size();
+                        cellsInComponent.push_back(cell);
+                        visited.push_back(cell);
+                        for (int k = 0; k < 8; k++) {
+                            int n = cell + offsets[k];
+                            if (activePos[n] >= 0 && constraintOf[n] < 0) {
+                                constraintOf[n] = (int)numbers.size();
+                                numbers.push_back(n);
+                                visited.push_back(n);
+                            }
+                        }
+                    }
+                    constraintVars.back().push_back(varOf[cell]);
+                }
+            }
+            
+            int vars = (int)cellsInComponent.size();
+            if (vars > MAX_COMPONENT_CELLS
+                || !enumerator.enumerate(vars, constraintVars, needs, NODE_BUDGET)) {
+                continue;
+            }
+            double total = 0;
+            for (double s : enumerator.solutions) total += s;
+            if (total == 0) continue;   // inconsistent numbers, nothing sound to say
+            for (int v = 0; v < vars; v++) {
+                double mines = 0;
+                for (int k = 0; k <= vars; k++) mines += enumerator.cellMines[(size_t)v * (vars + 1) + k];
+                if (mines == 0 || mines == total) {
+                    learn(cellsInComponent[v], mines == 0 ? KNOWN_SAFE : KNOWN_MINE);
+                    progress = true;
+                }
+            }
+        }
+        for (int idx : visited) {
+            varOf[idx] = -1;
+            constraintOf[idx] = -1;
+        }
+        if (progress) deductions.enumerations++;
+        return progress;
+    }
+    
+public:
+    struct Counters {
+        long long safe, mines, pairwise, enumerations;
+    } deductions;
+    
+    Solver() : safeCursor(0), deductions{0, 0, 0, 0} {}
+    
+    // Start over on a board, syncing with whatever is already revealed
+    void attach(const BoardView& view) {
+        board = view;
+        int stride = view.stride;
+        int k = 0;
+        for (int dx = -1; dx <= 1; dx++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                if (dx != 0 || dy != 0) offsets[k++] = dx * stride + dy;
+            }
+        }
+        size_t total = boardBytes(view.rows, view.cols);
+        known.assign(total, 0);
+        queued.assign(total, 0);
+        activePos.assign(total, -1);
+        varOf.assign(total, -1);
+        constraintOf.assign(total, -1);
+        pending.clear();
+        touched.clear();
+        active.clear();
+        safeList.clear();
+        mineList.clear();
+        safeCursor = 0;
+        deductions = Counters{0, 0, 0, 0};
+        if (view.frontier) {
+            // Only numbers next to a hidden cell can lead anywhere
+            for (int cell : view.frontier->cells()) {
+                for (int n = 0; n < 8; n++) {
+                    if (isNumber(cell + offsets[n])) enqueue(cell + offsets[n]);
+                }
+            }
+        } else {
+            for (int i = 0; i < view.rows; i++) {
+                for (int j = 0; j < view.cols; j++) {
+                    if (isNumber(view.index(i, j))) enqueue(view.index(i, j));
+                }
+            }
+        }
+        propagate();
+    }
+    
+    // Feed the cells revealed by the last move
+    void update(const vector<int>& revealed) {
+        for (int idx : revealed) {
+            if (!(board.cells[idx] & REVEALED_BIT)) continue;   // e.g. a flag change
+            if (isNumber(idx)) enqueue(idx);
+            for (int k = 0; k < 8; k++) {
+                if (isNumber(idx + offsets[k])) enqueue(idx + offsets[k]);
+            }
+        }
+        propagate();
+    }
+    
+    // An unrevealed cell proven safe, or -1 if none can be deduced
+    int nextSafe() {
+        while (true) {
+            while (safeCursor < safeList.size()) {
+                int idx = safeList[safeCursor];
+                if (!(board.cells[idx] & REVEALED_BIT)) return idx;
+                safeCursor++;
+            }
+            if (!enumerateFrontier()) return -1;
+            propagate();
+        }
+    }
+    
+    // Deduced mines the player has not flagged yet
+    int nextUnflaggedMine() const {
+        for (int idx : mineList) {
+            if (!(board.cells[idx] & FLAGGED_BIT)) return idx;
+        }
+        return -1;
+    }
+    
+    // Re-check the numbers around a cell whose mine content changed
+    void touch(int idx) {
+        for (int k = 0; k < 8; k++) {
+            if (isNumber(idx + offsets[k])) enqueue(idx + offsets[k]);
+        }
+        propagate();
+    }
+    
+    // Numbers that still have unknown neighbors, and those neighbors
+    const vector<int>& frontierNumbers() const { return active; }
+    int unknownAround(int idx, int* unknown) const {
+        int need;
+        return gather(idx, unknown, need);
+    }
+    
+    bool isKnown(int idx) const { return known[idx] != 0; }
+    bool isKnownSafe(int idx) const { return known[idx] == KNOWN_SAFE; }
+    bool isKnownMine(int idx) const { return known[idx] == KNOWN_MINE; }
+};
+
+// DSA: Mine probability for every unrevealed cell, given the revealed
+// numbers and the total mine count (flags are ignored). Unknown cells next
+// to numbers split into components that share no number. Small components
+// are enumerated exactly (solutions tallied by mine count) and combined
+// across components by convolution, weighted by the ways to place the
+// leftover mines among the interior cells, C(interior, leftover). Components
+// too big to enumerate are sampled by parallel Metropolis chains with
+// independently seeded generators, which stop early once every sampled
+// cell's standard error is below the target. All interior cells share one
+// probability, expected leftover mines / interior cells, which is kept as a
+// single value: only cells next to a number get their own entry.
+class ProbabilityEstimator {
+public:
+    struct Settings {
+        int threads;
+        double targetError;      // stop sampling below this standard error
+        double maxSeconds;       // sampling time budget per estimate
+        uint64_t seed;
+    };
+    
+    struct Report {
+        int exactComponents, sampledComponents, sampledCells;
+        long long samples;       // zero-violation chain states recorded
+        double maxError;         // worst sampled-cell standard error
+        double seconds;
+    };
+    
+private:
+    struct Component {
+        vector<int> cells;
+        vector<vector<int>> constraintVars;
+        vector<int> needs;
+        vector<double> solutions, cellMines;   // scaled so max(solutions) = 1
+    };
+    
+    // Sampled variables with their constraints (the union of big components)
+    struct Chain {
+        vector<int> cells;
+        vector<vector<int>> varConstraints;
+        vector<vector<int>> partners;    // other variables sharing a constraint
+        vector<int> needs;
+        vector<double> logWeight;        // log weight of a chain state by its mine count
+    };
+    
+    Settings settings;
+    BoardView board;
+    const Solver* known;
+    int offsets[8];
+    vector<double> probability;      // by board index, -1 unless in assigned
+    vector<int> assigned;            // cells given their own probability
+    double interiorProbability;
+    int interiorCells, interiorSample;   // count, and any one of them (-1 if none)
+    vector<int> varOf, constraintOf;
+    vector<int> constrained;         // numbers given a constraintOf entry
+    ComponentEnumerator enumerator;
+    Report report;
+    
+    static vector<double> convolve(const vector<double>& a, const vector<double>& b) {
+        vector<double> out(a.size() + b.size() - 1, 0.0);
+        for (size_t i = 0; i < a.size(); i++) {
+            if (a[i] == 0) continue;
+            for (size_t j = 0; j < b.size(); j++) out[i + j] += a[i] * b[j];
+        }
+        return out;
+    }
+    
+    static double logChoose(int n, int k) {
+        return lgamma(n + 1.0) - lgamma(k + 1.0) - lgamma(n - k + 1.0);
+    }
+    
+    bool isNumber(int idx) const {
+        return (board.cells[idx] & (REVEALED_BIT | BORDER_BIT | MINE_BIT)) == REVEALED_BIT;
+    }
+    
+    // 1 = certainly a mine (detonated or deduced), 2 = deduced safe, 0 = unknown
+    int fixedState(int idx) const {
+        uint8_t cell = board.cells[idx];
+        if (cell & REVEALED_BIT) return (cell & MINE_BIT) ? 1 : 2;
+        if (known && known->isKnownMine(idx)) return 1;
+        if (known && known->isKnownSafe(idx)) return 2;
+        return 0;
+    }
+    
+    // Start a component at an unknown frontier cell, or account for a
+    // fixed or interior cell
+    void collectCell(int idx, vector<Component>& components, int& interior, int& fixedMines) {
+        int state = fixedState(idx);
+        if (state != 0) {
+            fixedMines += state == 1;
+            if (!(board.cells[idx] & REVEALED_BIT)) {
+                probability[idx] = state == 1 ? 1.0 : 0.0;
+                assigned.push_back(idx);
+            }
+            return;
+        }
+        if (varOf[idx] >= 0) return;
+        bool frontier = false;
+        for (int k = 0; k < 8 && !frontier; k++) frontier = isNumber(idx + offsets[k]);
+        if (!frontier) {
+            if (interior++ == 0) interiorSample = idx;
+            return;
+        }
+        
+        // Breadth-first over cells and the numbers around them
+        components.push_back(Component());
+        Component& comp = components.back();
+        varOf[idx] = 0;
+        comp.cells.push_back(idx);
+        assigned.push_back(idx);
+        for (size_t q = 0; q < comp.cells.size(); q++) {
+            for (int k = 0; k < 8; k++) {
+                int number = comp.cells[q] + offsets[k];
+                if (!isNumber(number) || constraintOf[number] >= 0) continue;
+                constraintOf[number] = (int)comp.needs.size();
+                constrained.push_back(number);
+                int need = board.cells[number] & COUNT_MASK;
+                comp.constraintVars.push_back(vector<int>());
+                for (int m = 0; m < 8; m++) {
+                    int n = number + offsets[m];
+                    int neighborState = fixedState(n);
+                    if (neighborState == 1) {
+                        need--;
+                    } else if (neighborState == 0) {
+                        if (varOf[n] < 0) {
+                            varOf[n] = (int)comp.cells.size();
+                            comp.cells.push_back(n);
+                            assigned.push_back(n);
+                        }
+                        comp.constraintVars.back().push_back(varOf[n]);
+                    }
+                }
+                comp.needs.push_back(need);
+            }
+        }
+    }
+    
+    // Split the frontier into components; counts interior cells and
+    // certain mines on the way. With a tracked frontier only its cells are
+    // visited (deductions always sit next to a number) and it supplies the
+    // interior sample, otherwise the whole board is scanned.
+    void collect(vector<Component>& components, int& interior, int& fixedMines) {
+        interior = fixedMines = 0;
+        interiorSample = -1;
+        if (board.frontier) {
+            const vector<int>& frontierCells = board.frontier->cells();
+            for (int idx : frontierCells) collectCell(idx, components, interior, fixedMines);
+            interior = board.frontier->getHiddenCells() - (int)frontierCells.size();
+            interiorSample = board.frontier->interiorCell();
+            fixedMines += board.frontier->getRevealedMines();
+            return;
+        }
+        for (int i = 0; i < board.rows; i++) {
+            for (int j = 0; j < board.cols; j++) {
+                collectCell(board.index(i, j), components, interior, fixedMines);
+            }
+        }
+    }
+    
+    // One Metropolis chain over the sampled variables. A move flips one
+    // cell, or swaps a mine with a safe cell sharing a number with it.
+    // States are scored by their mine-count weight and a penalty per
+    // violated mine; only states with no violations are recorded, once per
+    // sweep (after a burn-in).
+    struct ChainState {
+        Xoshiro256 rng;
+        vector<uint8_t> x;
+        vector<int> sum;             // mines per constraint
+        int mines, violations, sweeps;
+        long long samples;
+        vector<double> cellMines;    // per variable, over recorded states
+        vector<double> mineCounts;   // recorded states by mine count
+    };
+    
+    // Per-chain results shared between the workers
+    struct ChainTotals {
+        mutex lock;
+        vector<vector<double>> cellMines, mineCounts;
+        vector<long long> samples;
+        atomic<bool> stop;
+    };
+    
+    static int flip(const Chain& chain, ChainState& state, int v) {
+        int delta = state.x[v] ? -1 : 1;
+        int change = 0;
+        for (int c : chain.varConstraints[v]) {
+            change -= abs(state.sum[c] - chain.needs[c]);
+            state.sum[c] += delta;
+            change += abs(state.sum[c] - chain.needs[c]);
+        }
+        state.x[v] ^= 1;
+        state.mines += delta;
+        state.violations += change;
+        return change;
+    }
+    
+    static void startChain(const Chain& chain, ChainState& state, uint64_t chainSeed) {
+        int n = (int)chain.cells.size();
+        state.rng.reseed(chainSeed);
+        state.x.assign(n, 0);
+        state.sum.assign(chain.needs.size(), 0);
+        state.mines = state.sweeps = 0;
+        state.samples = 0;
+        state.cellMines.assign(n, 0.0);
+        state.mineCounts.assign(n + 1, 0.0);
+        state.violations = 0;
+        for (int need : chain.needs) state.violations += need;
+        for (int v = 0; v < n; v++) {
+            if (state.rng.nextBelow(4) == 0) flip(chain, state, v);
+        }
+    }
+    
+    static void runSweeps(const Chain& chain, ChainState& state, int sweeps) {
+        const double PENALTY = 2.5;
+        const int BURN_IN_SWEEPS = 16;
+        int n = (int)chain.cells.size();
+        for (int s = 0; s < sweeps; s++, state.sweeps++) {
+            for (int step = 0; step < n; step++) {
+                int v = (int)state.rng.nextBelow((uint32_t)n);
+                int oldMines = state.mines;
+                int u = -1;
+                if ((state.rng.next() & 1) && !chain.partners[v].empty()) {
+                    u = chain.partners[v][state.rng.nextBelow((uint32_t)chain.partners[v].size())];
+                    if (state.x[u] == state.x[v]) continue;
+                }
+                int change = flip(chain, state, v);
+                if (u >= 0) change += flip(chain, state, u);
+                double logRatio = chain.logWeight[state.mines] - chain.logWeight[oldMines] - PENALTY * change;
+                if (!(logRatio >= 0) && (double)(state.rng.next() >> 11) * 0x1.0p-53 >= exp(logRatio)) {
+                    if (u >= 0) flip(chain, state, u);
+                    flip(chain, state, v);
+                }
+            }
+            if (state.sweeps >= BURN_IN_SWEEPS && state.violations == 0) {
+                state.samples++;
+                state.mineCounts[state.mines] += 1;
+                for (int v = 0; v < n; v++) state.cellMines[v] += state.x[v];
+            }
+        }
+    }
+    
+    // Worst standard error over the sampled cells: the larger of the
+    // binomial error (sweeps treated as independent) and the spread between
+    // chain means, which exposes chains stuck in different modes
+    static double worstError(const ChainTotals& totals, long long& sampleTotal) {
+        size_t chains = totals.samples.size(), n = totals.cellMines[0].size();
+        sampleTotal = 0;
+        for (size_t c = 0; c < chains; c++) {
+            if (totals.samples[c] == 0) return 1;
+            sampleTotal += totals.samples[c];
+        }
+        double worst = 0;
+        for (size_t v = 0; v < n; v++) {
+            double mines = 0, meanSum = 0, meanSquares = 0;
+            for (size_t c = 0; c < chains; c++) {
+                double mean = totals.cellMines[c][v] / totals.samples[c];
+                mines += totals.cellMines[c][v];
+                meanSum += mean;
+                meanSquares += mean * mean;
+            }
+            double p = (mines + 1) / (sampleTotal + 2);
+            double spread = (meanSquares - meanSum * meanSum / chains) / (chains - 1);
+            worst = max(worst, sqrt(max(p * (1 - p) / sampleTotal, max(0.0, spread) / chains)));
+        }
+        return worst;
+    }
+    
+    // Worker: advances chains id, id + workers, ... a round at a time and
+    // publishes their totals until the error target or the time budget is hit
+    void runWorker(const Chain& chain, int id, int workers, ChainTotals& totals,
+                   chrono::steady_clock::time_point started) {
+        const int ROUND_SWEEPS = 32;
+        const long long MIN_SAMPLES = 256;
+        vector<ChainState> states;
+        vector<size_t> ids;
+        for (size_t c = id; c < totals.samples.size(); c += workers) {
+            states.push_back(ChainState());
+            startChain(chain, states.back(), streamSeed(settings.seed, c));
+            ids.push_back(c);
+        }
+        while (!totals.stop.load(memory_order_relaxed)) {
+            for (ChainState& state : states) runSweeps(chain, state, ROUND_SWEEPS);
+            
+            lock_guard<mutex> guard(totals.lock);
+            for (size_t i = 0; i < states.size(); i++) {
+                totals.cellMines[ids[i]] = states[i].cellMines;
+                totals.mineCounts[ids[i]] = states[i].mineCounts;
+                totals.samples[ids[i]] = states[i].samples;
+            }
+            long long sampleTotal;
+            double worst = worstError(totals, sampleTotal);
+            report.maxError = worst;
+            if ((sampleTotal >= MIN_SAMPLES && worst <= settings.targetError)
+                || chrono::duration<double>(chrono::steady_clock::now() - started).count() > settings.maxSeconds) {
+                totals.stop = true;
+            }
+        }
+    }
+    
+    // Mean-field weighting for boards with very many components. The
+    // interior term C(interior, leftover - t) is replaced by odds^t at the
+    // interior density, which makes the components independent. The
+    // density is the fixed point of (leftover - expected frontier mines) /
+    // interior cells.
+    void weighIndependently(const vector<const Component*>& exact, Chain& chain, int interior, int leftover,
+                            chrono::steady_clock::time_point started) {
+        int sampled = (int)chain.cells.size();
+        int unknownCells = interior + sampled;
+        for (const Component* comp : exact) unknownCells += (int)comp->cells.size();
+        auto clampDensity = [](double p) { return max(1e-9, min(1 - 1e-9, p)); };
+        double density = clampDensity(unknownCells > 0 ? (double)leftover / unknownCells : 0.5);
+        
+        // Weights of a component's mine counts at the given odds, scaled to a maximum of 1
+        vector<double> weight;
+        auto weigh = [&](const Component& comp, double logOdds) {
+            int vars = (int)comp.cells.size();
+            double peak = -INFINITY;
+            for (int kk = 0; kk <= vars; kk++) if (comp.solutions[kk] > 0) peak = max(peak, kk * logOdds);
+            weight.assign(vars + 1, 0.0);
+            for (int kk = 0; kk <= vars; kk++) weight[kk] = exp(kk * logOdds - peak);
+        };
+        auto expectedExact = [&](double logOdds) {
+            double total = 0;
+            for (const Component* comp : exact) {
+                weigh(*comp, logOdds);
+                double norm = 0, mines = 0;
+                for (size_t kk = 0; kk < weight.size(); kk++) {
+                    norm += comp->solutions[kk] * weight[kk];
+                    mines += kk * comp->solutions[kk] * weight[kk];
+                }
+                total += norm > 0 ? mines / norm : 0;
+            }
+            return total;
+        };
+        for (int iteration = 0; iteration < 64 && interior > 0; iteration++) {
+            double frontierMines = expectedExact(log(density / (1 - density))) + sampled * density;
+            double next = clampDensity((leftover - frontierMines) / interior);
+            if (fabs(next - density) < 1e-9) break;
+            density = (density + next) / 2;
+        }
+        double logOdds = log(density / (1 - density));
+        
+        double sampledMines = sampled * density;
+        if (sampled > 0) {
+            chain.logWeight.assign(sampled + 1, 0.0);
+            for (int m = 0; m <= sampled; m++) chain.logWeight[m] = m * logOdds;
+            vector<double> mineTotals, countTotals;
+            long long sampleTotal = sampleChain(chain, started, mineTotals, countTotals);
+            report.samples = sampleTotal;
+            if (sampleTotal > 0) {
+                sampledMines = 0;
+                for (int m = 0; m <= sampled; m++) sampledMines += m * countTotals[m] / sampleTotal;
+            }
+            for (int v = 0; v < sampled; v++) {
+                probability[chain.cells[v]] = sampleTotal > 0 ? mineTotals[v] / sampleTotal : density;
+            }
+        }
+        
+        double exactMines = 0;
+        for (const Component* comp : exact) {
+            weigh(*comp, logOdds);
+            int vars = (int)comp->cells.size();
+            double norm = 0, mines = 0;
+            for (int kk = 0; kk <= vars; kk++) {
+                norm += comp->solutions[kk] * weight[kk];
+                mines += kk * comp->solutions[kk] * weight[kk];
+            }
+            exactMines += norm > 0 ? mines / norm : 0;
+            for (int v = 0; v < vars; v++) {
+                double cellMines = 0;
+                for (int kk = 0; kk <= vars; kk++) cellMines += comp->cellMines[(size_t)v * (vars + 1) + kk] * weight[kk];
+                probability[comp->cells[v]] = norm > 0 ? cellMines / norm : 0.5;
+            }
+        }
+        if (interior > 0) interiorProbability = max(0.0, min(1.0, (leftover - exactMines - sampledMines) / interior));
+    }
+    
+    // Run the Metropolis chains on chain (logWeight set) until the error
+    // target or the time budget is met; sums the recorded states per cell
+    // and per mine count, returns how many were recorded
+    long long sampleChain(Chain& chain, chrono::steady_clock::time_point started,
+                          vector<double>& mineTotals, vector<double>& countTotals) {
+        int sampled = (int)chain.cells.size();
+        // Variables sharing a constraint are swap partners
+        vector<vector<int>> constraintVars(chain.needs.size());
+        for (int v = 0; v < sampled; v++) {
+            for (int c : chain.varConstraints[v]) constraintVars[c].push_back(v);
+        }
+        chain.partners.assign(sampled, vector<int>());
+        for (const vector<int>& vars : constraintVars) {
+            for (int v : vars) {
+                for (int u : vars) {
+                    if (u != v) chain.partners[v].push_back(u);
+                }
+            }
+        }
+        for (vector<int>& list : chain.partners) {
+            sort(list.begin(), list.end());
+            list.erase(unique(list.begin(), list.end()), list.end());
+        }
+        
+        const int MIN_CHAINS = 4;
+        int workers = max(1, settings.threads);
+        int chains = max(MIN_CHAINS, workers);
+        ChainTotals totals;
+        totals.cellMines.assign(chains, vector<double>(sampled, 0.0));
+        totals.mineCounts.assign(chains, vector<double>(sampled + 1, 0.0));
+        totals.samples.assign(chains, 0);
+        totals.stop = false;
+        vector<thread> threads;
+        for (int t = 1; t < workers; t++) {
+            threads.emplace_back([&, t]() { runWorker(chain, t, workers, totals, started); });
+        }
+        runWorker(chain, 0, workers, totals, started);
+        for (thread& worker : threads) worker.join();
+        
+        long long sampleTotal = 0;
+        mineTotals.assign(sampled, 0.0);
+        countTotals.assign(sampled + 1, 0.0);
+        for (int c = 0; c < chains; c++) {
+            sampleTotal += totals.samples[c];
+            for (int v = 0; v < sampled; v++) mineTotals[v] += totals.cellMines[c][v];
+            for (int m = 0; m <= sampled; m++) countTotals[m] += totals.mineCounts[c][m];
+        }
+        return sampleTotal;
+    }
+    
+public:
+    explicit ProbabilityEstimator(Settings config = Settings{1, 0.01, 0.05, 1})
+        : settings(config), known(nullptr), interiorProbability(-1), interiorCells(0), interiorSample(-1),
+          report{0, 0, 0, 0, 0.0, 0.0} {}
+    
+    // Estimate every unrevealed cell's mine probability; read them with
+    // probabilityAt. Solver deductions, when given, are taken as certain
+    // and shrink the components that have to be counted or sampled
+    void estimate(const BoardView& view, int totalMines, const Solver* solver = nullptr) {
+        const int MAX_EXACT_CELLS = 48;
+        const long long NODE_BUDGET = 200000;
+        auto started = chrono::steady_clock::now();
+        board = view;
+        int k = 0;
+        for (int dx = -1; dx <= 1; dx++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                if (dx != 0 || dy != 0) offsets[k++] = dx * view.stride + dy;
+            }
+        }
+        // Per-cell tables are only cleared where the last estimate wrote,
+        // so with a tracked frontier the work follows the frontier size
+        size_t total = boardBytes(view.rows, view.cols);
+        if (probability.size() != total) {
+            probability.assign(total, -1.0);
+            varOf.assign(total, -1);
+            constraintOf.assign(total, -1);
+        } else {
+            for (int idx : assigned) {
+                probability[idx] = -1.0;
+                varOf[idx] = -1;
+            }
+            for (int idx : constrained) constraintOf[idx] = -1;
+        }
+        assigned.clear();
+        constrained.clear();
+        interiorProbability = -1;
+        report = Report{0, 0, 0, 0, 0.0, 0.0};
+        
+        vector<Component> components;
+        known = solver;
+        int interior, fixedMines;
+        collect(components, interior, fixedMines);
+        interiorCells = interior;
+        int leftover = totalMines - fixedMines;
+        
+        // Exact components become mine-count distributions; the rest go to the chain
+        vector<const Component*> exact;
+        Chain chain;
+        for (Component& comp : components) {
+            int vars = (int)comp.cells.size();
+            if (vars <= MAX_EXACT_CELLS && enumerator.enumerate(vars, comp.constraintVars, comp.needs, NODE_BUDGET)) {
+                double peak = *max_element(enumerator.solutions.begin(), enumerator.solutions.end());
+                if (peak > 0) {
+                    comp.solutions = enumerator.solutions;
+                    comp.cellMines = enumerator.cellMines;
+                    for (double& value : comp.solutions) value /= peak;
+                    for (double& value : comp.cellMines) value /= peak;
+                    exact.push_back(&comp);
+                    continue;
+                }
+            }
+            int base = (int)chain.cells.size();
+            for (int cell : comp.cells) {
+                chain.cells.push_back(cell);
+                chain.varConstraints.push_back(vector<int>());
+            }
+            for (size_t c = 0; c < comp.needs.size(); c++) {
+                for (int v : comp.constraintVars[c]) chain.varConstraints[base + v].push_back((int)chain.needs.size());
+                chain.needs.push_back(comp.needs[c]);
+            }
+            report.sampledComponents++;
+        }
+        report.exactComponents = (int)exact.size();
+        report.sampledCells = (int)chain.cells.size();
+        int sampled = (int)chain.cells.size();
+        
+        // Combining the exact components below costs about count * span^2,
+        // span being their total cell count; past a budget (thousands of
+        // openings on a huge board) they are weighed independently instead
+        const double MAX_COMBINE_WORK = 2e8;
+        size_t count = exact.size();
+        double span = 1;
+        for (const Component* comp : exact) span += (double)comp->cells.size();
+        if ((double)count * span * span > MAX_COMBINE_WORK) {
+            weighIndependently(exact, chain, interior, leftover, started);
+            report.seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+            return;
+        }
+        
+        // prefix[i] / suffix[i]: distribution of exact components before / from i
+        vector<vector<double>> prefix(count + 1, vector<double>(1, 1.0)), suffix(count + 1, vector<double>(1, 1.0));
+        for (size_t i = 0; i < count; i++) prefix[i + 1] = convolve(prefix[i], exact[i]->solutions);
+        for (size_t i = count; i-- > 0;) suffix[i] = convolve(exact[i]->solutions, suffix[i + 1]);
+        const vector<double>& allExact = prefix[count];
+        
+        // Interior weight by frontier mine total t: C(interior, leftover - t),
+        // scaled to a maximum of 1; ignore the global count if it cannot fit
+        int maxTotal = (int)allExact.size() - 1 + sampled;
+        vector<double> interiorWeight(maxTotal + 1, 0.0);
+        double peakLog = -INFINITY;
+        for (int t = 0; t <= maxTotal; t++) {
+            if (leftover - t >= 0 && leftover - t <= interior) peakLog = max(peakLog, logChoose(interior, leftover - t));
+        }
+        for (int t = 0; t <= maxTotal; t++) {
+            interiorWeight[t] = peakLog == -INFINITY ? 1.0
+                              : (leftover - t >= 0 && leftover - t <= interior) ? exp(logChoose(interior, leftover - t) - peakLog) : 0.0;
+        }
+        
+        // Sampled components: the chain's mine count m is weighted by
+        // g(m) = sum_j allExact[j] * interiorWeight[m + j]
+        vector<double> sampledCounts(1, 1.0);     // relative configuration counts by m
+        if (sampled > 0) {
+            vector<double> g(sampled + 1, 0.0);
+            chain.logWeight.assign(sampled + 1, -INFINITY);
+            for (int m = 0; m <= sampled; m++) {
+                for (size_t j = 0; j < allExact.size(); j++) g[m] += allExact[j] * interiorWeight[m + j];
+                if (g[m] > 0) chain.logWeight[m] = log(g[m]);
+            }
+            
+            vector<double> mineTotals, countTotals;
+            long long sampleTotal = sampleChain(chain, started, mineTotals, countTotals);
+            report.samples = sampleTotal;
+            sampledCounts.assign(sampled + 1, 0.0);
+            for (int v = 0; v < sampled; v++) {
+                probability[chain.cells[v]] = sampleTotal > 0 ? mineTotals[v] / sampleTotal
+                                                              : (double)leftover / (interior + sampled);
+            }
+            for (int m = 0; m <= sampled; m++) {
+                if (g[m] > 0) sampledCounts[m] = sampleTotal > 0 ? countTotals[m] / g[m] : 1.0;
+            }
+        }
+        
+        // Exact components: weight each own mine count k by every way the
+        // other components and the interior can complete the board
+        for (size_t i = 0; i < count; i++) {
+            const Component& comp = *exact[i];
+            vector<double> others = convolve(convolve(prefix[i], suffix[i + 1]), sampledCounts);
+            int vars = (int)comp.cells.size();
+            vector<double> weight(vars + 1, 0.0);
+            double norm = 0;
+            for (int kk = 0; kk <= vars; kk++) {
+                for (size_t j = 0; j < others.size() && kk + j < interiorWeight.size(); j++) {
+                    weight[kk] += others[j] * interiorWeight[kk + j];
+                }
+                norm += comp.solutions[kk] * weight[kk];
+            }
+            for (int v = 0; v < vars; v++) {
+                double mines = 0;
+                for (int kk = 0; kk <= vars; kk++) mines += comp.cellMines[(size_t)v * (vars + 1) + kk] * weight[kk];
+                probability[comp.cells[v]] = norm > 0 ? mines / norm : 0.5;
+            }
+        }
+        
+        // Interior: expected leftover mines over the interior cells
+        if (interior > 0) {
+            vector<double> frontier = convolve(allExact, sampledCounts);
+            double norm = 0, expected = 0;
+            for (size_t t = 0; t < frontier.size(); t++) {
+                double w = frontier[t] * interiorWeight[t];
+                norm += w;
+                expected += w * (leftover - (double)t);
+            }
+            interiorProbability = norm > 0 ? max(0.0, min(1.0, expected / norm / interior)) : (double)leftover / interior;
+        }
+        report.seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    }
+    
+    // Mine probability of cell idx in the last estimate (-1 for revealed
+    // and border cells); every interior cell reads the shared value
+    double probabilityAt(int idx) const {
+        if (board.cells[idx] & REVEALED_BIT) return -1;
+        return probability[idx] >= 0 ? probability[idx] : interiorProbability;
+    }
+    
+    // Lowest-probability unrevealed cell of the last estimate, or -1; ties
+    // go to the lower index. The interior is represented by one sample
+    // cell, as all its cells share one value.
+    int safestCell() const {
+        int best = interiorCells > 0 ? interiorSample : -1;
+        double lowest = interiorProbability;
+        for (int idx : assigned) {
+            if (best < 0 || probability[idx] < lowest || (probability[idx] == lowest && idx < best)) {
+                best = idx;
+                lowest = probability[idx];
+            }
+        }
+        return best;
+    }
+    
+    const Report& getReport() const { return report; }
+};
+
+// DSA: Chunked sparse board for huge or endless maps. The board is cut
+// into 64x64 tiles kept in a hash map and created on first touch. A tile's
+// mines depend only on the seed and its coordinates, so tiles can be built
+// in any order. Numbering a tile needs its neighbors' mines only, so the
+// ring around the explored area is kept as 512-byte mine bitmaps instead
+// of full tiles. Memory is proportional to the explored area.
+class ChunkedBoard {
+public:
+    static const int TILE = 64;
+    
+    static long long floorDiv(long long a, long long b) {
+        return a >= 0 ? a / b : -((-a + b - 1) / b);
+    }
+    
+    static uint64_t tileKey(long long tx, long long ty) {
+        return (uint64_t)(uint32_t)tx << 32 | (uint32_t)ty;
+    }
+    
+private:
+    struct Tile {
+        uint8_t cells[TILE * TILE];   // same bit encoding as Minesweeper
+        bool numbered;
+    };
+    
+    // Mines of a tile that is only read for numbering, one bit per cell
+    struct MineLayout {
+        uint64_t bits[TILE * TILE / 64];
+    };
+    
+    uint64_t seed;
+    double density;
+    long long rows, cols;             // 0 = unbounded in that direction
+    unordered_map<uint64_t, unique_ptr<Tile>> tiles;
+    unordered_map<uint64_t, unique_ptr<MineLayout>> ring;   // tiles not played yet
+    vector<pair<long long, long long>> changed;
+    vector<pair<long long, long long>> fillStack;
+    long long revealedSafe, flagsPlaced;
+    bool mineHit;
+    
+    bool inBounds(long long x, long long y) const {
+        return (rows == 0 || (x >= 0 && x < rows)) && (cols == 0 || (y >= 0 && y < cols));
+    }
+    
+    // Floyd sampling over the tile's in-bounds cells, seeded per tile
+    void dealMines(long long tx, long long ty, MineLayout& layout) const {
+        memset(layout.bits, 0, sizeof(layout.bits));
+        vector<int> playable;
+        playable.reserve(TILE * TILE);
+        for (int i = 0; i < TILE; i++) {
+            for (int j = 0; j < TILE; j++) {
+                if (inBounds(tx * TILE + i, ty * TILE + j)) playable.push_back(i * TILE + j);
+            }
+        }
+        int total = (int)playable.size();
+        int mines = (int)(density * total + 0.5);
+        Xoshiro256 rng(streamSeed(seed, tileKey(tx, ty)));
+        for (int j = total - mines; j < total; j++) {
+            int k = (int)rng.nextBelow((uint32_t)j + 1);
+            if (layout.bits[playable[k] >> 6] >> (playable[k] & 63) & 1) k = j;
+            layout.bits[playable[k] >> 6] |= 1ULL << (playable[k] & 63);
+        }
+    }
+    
+    // Tile with its mines placed (not necessarily numbered); a ring layout
+    // dealt earlier is promoted rather than dealt again
+    Tile& mineTile(long long tx, long long ty) {
+        uint64_t key = tileKey(tx, ty);
+        unique_ptr<Tile>& slot = tiles[key];
+        if (slot) return *slot;
+        MineLayout dealt;
+        const MineLayout* layout = &dealt;
+        auto found = ring.find(key);
+        if (found != ring.end()) {
+            layout = found->second.get();
+        } else {
+            dealMines(tx, ty, dealt);
+        }
+        slot.reset(new Tile());
+        for (int k = 0; k < TILE * TILE; k++) {
+            slot->cells[k] = (layout->bits[k >> 6] >> (k & 63) & 1) ? MINE_BIT : 0;
+        }
+        slot->numbered = false;
+        if (found != ring.end()) ring.erase(found);
+        return *slot;
+    }
+    
+    bool mineAt(long long x, long long y) {
+        if (!inBounds(x, y)) return false;
+        long long tx = floorDiv(x, TILE), ty = floorDiv(y, TILE);
+        int k = (int)((x - tx * TILE) * TILE + (y - ty * TILE));
+        uint64_t key = tileKey(tx, ty);
+        auto tile = tiles.find(key);
+        if (tile != tiles.end()) return tile->second->cells[k] & MINE_BIT;
+        unique_ptr<MineLayout>& layout = ring[key];
+        if (!layout) {
+            layout.reset(new MineLayout());
+            dealMines(tx, ty, *layout);
+        }
+        return layout->bits[k >> 6] >> (k & 63) & 1;
+    }
+    
+    // Tile with adjacent-mine counts filled in; edge cells look across
+    // into the neighbor tiles' mine layouts
+    Tile& numberedTile(long long tx, long long ty) {
+        Tile& tile = mineTile(tx, ty);
+        if (tile.numbered) return tile;
+        for (int i = 0; i < TILE; i++) {
+            for (int j = 0; j < TILE; j++) {
+                long long x = tx * TILE + i, y = ty * TILE + j;
+                int count = 0;
+                for (int dx = -1; dx <= 1; dx++) {
+                    for (int dy = -1; dy <= 1; dy++) {
+                        if (dx == 0 && dy == 0) continue;
+                        int ni = i + dx, nj = j + dy;
+                        if (ni >= 0 && ni < TILE && nj >= 0 && nj < TILE) {
+                            count += (tile.cells[ni * TILE + nj] & MINE_BIT) >> 4;
+                        } else {
+                            count += mineAt(x + dx, y + dy);
+                        }
+                    }
+                }
+                tile.cells[i * TILE + j] |= (uint8_t)count;
+            }
+        }
+        tile.numbered = true;
+        return tile;
+    }
+    
+    uint8_t& cellRef(long long x, long long y) {
+        long long tx = floorDiv(x, TILE), ty = floorDiv(y, TILE);
+        return numberedTile(tx, ty).cells[(x - tx * TILE) * TILE + (y - ty * TILE)];
+    }
+    
+    void markRevealed(long long x, long long y, uint8_t& cell) {
+        cell |= REVEALED_BIT;
+        changed.push_back(make_pair(x, y));
+        if (cell & MINE_BIT) mineHit = true;
+        else revealedSafe++;
+    }
+    
+public:
+    // Unbounded boards need at least this density, or a zero region can
+    // percolate forever and a single click would never finish
+    static constexpr double MIN_ENDLESS_DENSITY = 0.12;
+    
+    ChunkedBoard(uint64_t boardSeed, double mineDensity, long long r = 0, long long c = 0)
+        : seed(boardSeed), density(mineDensity), rows(r), cols(c),
+          revealedSafe(0), flagsPlaced(0), mineHit(false) {}
+    
+    // Full cell byte at (x, y); out-of-bounds cells read as border
+    uint8_t cellAt(long long x, long long y) {
+        if (!inBounds(x, y)) return BORDER_BIT | REVEALED_BIT;
+        return cellRef(x, y);
+    }
+    
+    // Open every hidden, unflagged start cell, then flood from the zeros
+    // with a worklist that crosses tile boundaries. Cells owns() rejects are
+    // neither read nor opened: start cells are dropped, flood neighbors are
+    // appended to *outside for whoever holds them. Returns the coordinates
+    // of every newly revealed cell.
+    template <typename Owns>
+    const vector<pair<long long, long long>>& open(const pair<long long, long long>* starts, size_t count,
+                                                   Owns owns, vector<pair<long long, long long>>* outside) {
+        changed.clear();
+        fillStack.clear();
+        for (size_t s = 0; s < count; s++) {
+            long long x = starts[s].first, y = starts[s].second;
+            if (!inBounds(x, y) || !owns(x, y)) continue;
+            uint8_t& start = cellRef(x, y);
+            if (start & (REVEALED_BIT | FLAGGED_BIT)) continue;
+            markRevealed(x, y, start);
+            if (!(start & (MINE_BIT | COUNT_MASK))) fillStack.push_back(starts[s]);
+        }
+        
+        while (!fillStack.empty()) {
+            pair<long long, long long> cell = fillStack.back();
+            fillStack.pop_back();
+            for (int dx = -1; dx <= 1; dx++) {
+                for (int dy = -1; dy <= 1; dy++) {
+                    long long nx = cell.first + dx, ny = cell.second + dy;
+                    if ((dx == 0 && dy == 0) || !inBounds(nx, ny)) continue;
+                    if (!owns(nx, ny)) {
+                        outside->push_back(make_pair(nx, ny));
+                        continue;
+                    }
+                    uint8_t& next = cellRef(nx, ny);
+                    if (next & (REVEALED_BIT | FLAGGED_BIT)) continue;
+                    markRevealed(nx, ny, next);
+                    if (!(next & COUNT_MASK)) fillStack.push_back(make_pair(nx, ny));
+                }
+            }
+        }
+        return changed;
+    }
+    
+    const vector<pair<long long, long long>>& reveal(long long x, long long y) {
+        pair<long long, long long> start(x, y);
+        return open(&start, 1, [](long long, long long) { return true; }, nullptr);
+    }
+    
+    const vector<pair<long long, long long>>& toggleFlag(long long x, long long y) {
+        changed.clear();
+        if (!inBounds(x, y)) return changed;
+        uint8_t& cell = cellRef(x, y);
+        if (cell & REVEALED_BIT) return changed;
+        cell ^= FLAGGED_BIT;
+        flagsPlaced += (cell & FLAGGED_BIT) ? 1 : -1;
+        changed.push_back(make_pair(x, y));
+        return changed;
+    }
+    
+    // First safe zero cell on a square spiral around (x, y), for the opening
+    bool findOpening(long long& x, long long& y) {
+        for (long long radius = 0; radius < 64 * TILE; radius++) {
+            for (long long dx = -radius; dx <= radius; dx++) {
+                for (long long dy = -radius; dy <= radius; dy++) {
+                    if (max(dx < 0 ? -dx : dx, dy < 0 ? -dy : dy) != radius) continue;
+                    if (inBounds(x + dx, y + dy) && (cellAt(x + dx, y + dy) & (MINE_BIT | COUNT_MASK)) == 0) {
+                        x += dx;
+                        y += dy;
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+    
+    // Copy a window into a padded cell buffer so the renderers can draw it
+    BoardView window(long long x0, long long y0, int windowRows, int windowCols, vector<uint8_t>& buffer) {
+        buffer.resize(boardBytes(windowRows, windowCols));
+        initBoardCells(buffer.data(), windowRows, windowCols);
+        int stride = windowCols + 2;
+        for (int i = 0; i < windowRows; i++) {
+            for (int j = 0; j < windowCols; j++) {
+                uint8_t cell = cellAt(x0 + i, y0 + j);
+                buffer[(size_t)(i + 1) * stride + j + 1] = (cell & BORDER_BIT) ? (uint8_t)0 : cell;
+            }
+        }
+        return BoardView{windowRows, windowCols, stride, buffer.data()};
+    }
+    
+    bool isMineHit() const { return mineHit; }
+    long long getRevealedSafe() const { return revealedSafe; }
+    long long getFlagsPlaced() const { return flagsPlaced; }
+    size_t tileCount() const { return tiles.size(); }
+    size_t ringTileCount() const { return ring.size(); }
+    size_t memoryBytes() const {
+        return tiles.size() * (sizeof(Tile) + sizeof(uint64_t) * 4) + ring.size() * (sizeof(MineLayout) + sizeof(uint64_t) * 4);
+    }
+};
+
+// DSA: Sharded shared world for one huge board and many players. Regions of
+// REGION x REGION tiles are hashed to shards, and each shard keeps its own
+// ChunkedBoard with the tiles it owns, plus mine-only layouts of the ring
+// it numbers against (tiles of other shards are never materialized). Tiles
+// are a pure function of (seed, density), so every shard builds identical
+// tiles and no board state is ever copied. A flood that reaches a cell on
+// another shard is not followed there: the cell joins a batch for that
+// shard, and batches are delivered in rounds until every flood has settled.
+// Reveal deltas go only to subscribers of the tile they land on, so each
+// shard's work follows the area played on it. The shards share one process;
+// a batch or a delta list is what a transport between nodes would carry,
+// and the rounds do not depend on shard order.
+class ShardedWorld {
+public:
+    static const int REGION = 4;
+    
+    struct Delta {
+        long long x, y;
+        uint8_t cell;
+    };
+    
+    struct ShardStats {
+        long long cellsRevealed = 0;
+        long long batchesIn = 0;        // boundary batches received
+        long long boundaryCellsIn = 0;  // cells in those batches
+        long long deltasSent = 0;
+    };
+    
+private:
+    typedef pair<long long, long long> Cell;
+    
+    struct Shard {
+        ChunkedBoard board;
+        vector<Cell> inbox, work;
+        vector<vector<Cell>> outbox;                        // per destination, this round
+        unordered_map<uint64_t, vector<int>> subscribers;   // owned tile -> subscriber ids
+        ShardStats stats;
+        
+        Shard(uint64_t seed, double density, int shards) : board(seed, density), outbox(shards) {}
+    };
+    
+    vector<unique_ptr<Shard>> shards;
+    ChunkedBoard layout;                 // never played: answers layout-only queries
+    vector<vector<Delta>> mailboxes;     // per subscriber
+    vector<Cell> outside;
+    long long rounds, mineHits;
+    
+    int ownerOfTile(long long tx, long long ty) const {
+        uint64_t region = ChunkedBoard::tileKey(ChunkedBoard::floorDiv(tx, REGION), ChunkedBoard::floorDiv(ty, REGION));
+        return (int)(streamSeed(0x5A4D, region) % shards.size());
+    }
+    
+    static long long tileOf(long long coordinate) {
+        return ChunkedBoard::floorDiv(coordinate, ChunkedBoard::TILE);
+    }
+    
+    // Send each newly revealed cell to the subscribers of its tile
+    void publish(Shard& shard, const vector<Cell>& cells) {
+        uint64_t lastKey = 0;
+        const vector<int>* watchers = nullptr;
+        bool looked = false;
+        for (const Cell& cell : cells) {
+            uint64_t key = ChunkedBoard::tileKey(tileOf(cell.first), tileOf(cell.second));
+            if (!looked || key != lastKey) {
+                auto found = shard.subscribers.find(key);
+                watchers = found == shard.subscribers.end() || found->second.empty() ? nullptr : &found->second;
+                lastKey = key;
+                looked = true;
+            }
+            if (!watchers) continue;
+            Delta delta{cell.first, cell.second, shard.board.cellAt(cell.first, cell.second)};
+            for (int id : *watchers) mailboxes[id].push_back(delta);
+            shard.stats.deltasSent += (long long)watchers->size();
+        }
+    }
+    
+    // Open shard s's inbox on its own board; cells owned elsewhere go to
+    // the shard's outboxes
+    void process(int s) {
+        Shard& shard = *shards[s];
+        shard.work.swap(shard.inbox);
+        shard.inbox.clear();
+        long long lastTile[2] = {LLONG_MIN, LLONG_MIN};
+        bool lastOwned = false;
+        auto owns = [&](long long x, long long y) {
+            long long tx = tileOf(x), ty = tileOf(y);
+            if (tx != lastTile[0] || ty != lastTile[1]) {
+                lastTile[0] = tx;
+                lastTile[1] = ty;
+                lastOwned = ownerOfTile(tx, ty) == s;
+            }
+            return lastOwned;
+        };
+        outside.clear();
+        long long safeBefore = shard.board.getRevealedSafe();
+        const vector<Cell>& opened = shard.board.open(shard.work.data(), shard.work.size(), owns, &outside);
+        shard.stats.cellsRevealed += (long long)opened.size();
+        mineHits += (long long)opened.size() - (shard.board.getRevealedSafe() - safeBefore);
+        publish(shard, opened);
+        for (const Cell& cell : outside) {
+            shard.outbox[ownerOfTile(tileOf(cell.first), tileOf(cell.second))].push_back(cell);
+        }
+        shard.work.clear();
+    }
+    
+    // Run rounds until no shard has input: every shard with an inbox floods,
+    // then the batches it produced are deduplicated and delivered
+    void settle() {
+        bool pending = true;
+        while (pending) {
+            pending = false;
+            bool worked = false;
+            for (int s = 0; s < (int)shards.size(); s++) {
+                if (shards[s]->inbox.empty()) continue;
+                process(s);
+                worked = true;
+            }
+            rounds += worked;
+            for (unique_ptr<Shard>& from : shards) {
+                for (int d = 0; d < (int)shards.size(); d++) {
+                    vector<Cell>& batch = from->outbox[d];
+                    if (batch.empty()) continue;
+                    sort(batch.begin(), batch.end());
+                    batch.erase(unique(batch.begin(), batch.end()), batch.end());
+                    Shard& to = *shards[d];
+                    to.inbox.insert(to.inbox.end(), batch.begin(), batch.end());
+                    to.stats.batchesIn++;
+                    to.stats.boundaryCellsIn += (long long)batch.size();
+                    batch.clear();
+                    pending = true;
+                }
+            }
+        }
+    }
+    
+public:
+    ShardedWorld(uint64_t seed, double density, int shardCount)
+        : layout(seed, density), rounds(0), mineHits(0) {
+        for (int s = 0; s < shardCount; s++) {
+            shards.emplace_back(new Shard(seed, density, shardCount));
+        }
+    }
+    
+    int shardOf(long long x, long long y) const { return ownerOfTile(tileOf(x), tileOf(y)); }
+    
+    void reveal(long long x, long long y) {
+        shards[shardOf(x, y)]->inbox.push_back(Cell(x, y));
+        settle();
+    }
+    
+    void toggleFlag(long long x, long long y) {
+        Shard& shard = *shards[shardOf(x, y)];
+        publish(shard, shard.board.toggleFlag(x, y));
+    }
+    
+    // State of any cell, read from the shard that owns it
+    uint8_t cellAt(long long x, long long y) { return shards[shardOf(x, y)]->board.cellAt(x, y); }
+    
+    // Opening search on the layout alone, so no shard builds tiles for it
+    bool findOpening(long long& x, long long& y) { return layout.findOpening(x, y); }
+    
+    int addSubscriber() {
+        mailboxes.emplace_back();
+        return (int)mailboxes.size() - 1;
+    }
+    
+    // Deltas for tile (tx, ty) are sent to subscriber id from now on
+    void subscribe(int id, long long tx, long long ty) {
+        shards[ownerOfTile(tx, ty)]->subscribers[ChunkedBoard::tileKey(tx, ty)].push_back(id);
+    }
+    
+    void unsubscribe(int id, long long tx, long long ty) {
+        vector<int>& watchers = shards[ownerOfTile(tx, ty)]->subscribers[ChunkedBoard::tileKey(tx, ty)];
+        watchers.erase(remove(watchers.begin(), watchers.end(), id), watchers.end());
+    }
+    
+    // Deltas received by subscriber id since its mailbox was last cleared
+    vector<Delta>& mailbox(int id) { return mailboxes[id]; }
+    
+    int shardCount() const { return (int)shards.size(); }
+    const ShardStats& stats(int s) const { return shards[s]->stats; }
+    size_t tileCount(int s) const { return shards[s]->board.tileCount(); }
+    size_t ringTileCount(int s) const { return shards[s]->board.ringTileCount(); }
+    size_t memoryBytes(int s) const { return shards[s]->board.memoryBytes(); }
+    long long getRounds() const { return rounds; }
+    long long getMineHits() const { return mineHits; }
+};
+
+// Board settings accepted for custom games
+bool validSettings(int rows, int cols, int mines) {
+    return rows > 0 && cols > 0 && mines > 0 && (int64_t)rows * cols <= INT32_MAX / 2
+        && mines < rows * cols;
+}
+
+// DSA: Save file format (version 1, little-endian):
+//   0  "MSSV"   4  version u16   6  flags u16 (SAVE_RLE)
+//   8  rows i32  12  cols i32  16  mines i32
+//  20  start mode u8  21  generated u8  22  reserved u16
+//  24  seed u64  32  payload bytes u64  40  FNV-1a of the payload u64
+// The payload is three bit planes over the playable cells in row-major
+// order: mines, revealed, flagged. Counts, stats and the win/loss state are
+// derived on load. Plain planes pack 8 cells per byte, LSB first; with
+// SAVE_RLE each plane is a list of LEB128 run lengths alternating between
+// clear and set cells, starting with clear.
+const uint16_t SAVE_VERSION = 1;
+const uint16_t SAVE_RLE = 1;
+const size_t SAVE_HEADER_BYTES = 48;
+
+inline void putLE(uint8_t* out, uint64_t value, int bytes) {
+    for (int b = 0; b < bytes; b++) out[b] = (uint8_t)(value >> (8 * b));
+}
+
+inline uint64_t getLE(const uint8_t* in, int bytes) {
+    uint64_t value = 0;
+    for (int b = 0; b < bytes; b++) value |= (uint64_t)in[b] << (8 * b);
+    return value;
+}
+
+// Append a LEB128 varint: 7 bits per byte, low bits first, high bit set
+// on every byte but the last
+inline void putVarint(vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+// Decode a LEB128 varint at in, advancing it; false if it is truncated or
+// longer than 9 bytes
+inline bool getVarint(const uint8_t*& in, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    int shift = 0;
+    do {
+        if (in == end || shift > 56) return false;
+        value |= (uint64_t)(*in & 0x7F) << shift;
+        shift += 7;
+    } while (*in++ & 0x80);
+    return true;
+}
+
+inline uint64_t fnv1a(const uint8_t* bytes, size_t size) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < size; i++) hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+    return hash;
+}
+
+// Read-only view of a whole file: mmap where available, otherwise one read
+class MappedFile {
+private:
+    const uint8_t* bytes;
+    size_t length;
+    bool mapped;
+    vector<uint8_t> fallback;
+    
+public:
+    MappedFile() : bytes(nullptr), length(0), mapped(false) {}
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    bool open(const string& path) {
+        close();
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        map(fd);
+        ::close(fd);
+        if (mapped) return true;
+#endif
+        FILE* in = fopen(path.c_str(), "rb");
+        if (!in) return false;
+        uint8_t block[1 << 16];
+        size_t got;
+        while ((got = fread(block, 1, sizeof(block), in)) > 0) {
+            fallback.insert(fallback.end(), block, block + got);
+        }
+        fclose(in);
+        bytes = fallback.data();
+        length = fallback.size();
+        return true;
+    }
+    
+#if defined(__unix__) || defined(__APPLE__)
+    // Map an open descriptor if it is a non-empty regular file
+    bool map(int fd) {
+        close();
+        struct stat info;
+        if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size <= 0) return false;
+        void* base = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base == MAP_FAILED) return false;
+        bytes = (const uint8_t*)base;
+        length = (size_t)info.st_size;
+        mapped = true;
+        return true;
+    }
+#endif
+    
+    void close() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (mapped) munmap((void*)bytes, length);
+#endif
+        mapped = false;
+        fallback.clear();
+        bytes = nullptr;
+        length = 0;
+    }
+    
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+};
+
+// DSA: Move journal for undo/redo. Each applied move keeps only the board
+// indices it changed, as a slice of one flat array, so undo and redo cost
+// O(cells changed) and memory grows with the cells touched, never with
+// whole-board snapshots. Recording a move drops any undone (redo) tail.
+class MoveJournal {
+public:
+    struct Entry {
+        Move move;
+        size_t begin, end;       // slice of deltas holding the changed cells
+    };
+    
+private:
+    vector<Entry> entries;
+    vector<int> deltas;
+    size_t cursor;               // entries[0, cursor) are applied
+    
+public:
+    MoveJournal() : cursor(0) {}
+    
+    void clear() {
+        entries.clear();
+        deltas.clear();
+        cursor = 0;
+    }
+    
+    void record(const Move& move, const vector<int>& changed) {
+        entries.resize(cursor);
+        deltas.resize(entries.empty() ? 0 : entries.back().end);
+        size_t begin = deltas.size();
+        deltas.insert(deltas.end(), changed.begin(), changed.end());
+        entries.push_back(Entry{move, begin, deltas.size()});
+        cursor++;
+    }
+    
+    bool canUndo() const { return cursor > 0; }
+    bool canRedo() const { return cursor < entries.size(); }
+    const Entry& stepBack() { return entries[--cursor]; }
+    const Entry& stepForward() { return entries[cursor++]; }
+    const int* cellsOf(const Entry& entry) const { return deltas.data() + entry.begin; }
+    
+    // Applied moves, oldest first
+    size_t appliedCount() const { return cursor; }
+    const Move& applied(size_t i) const { return entries[i].move; }
+};
+
+// Parse an optionally signed decimal at p, advancing p; false if none
+// (or if it does not fit in a long long)
+inline bool parseInt(const char*& p, const char* last, long long& value) {
+    while (p < last && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    from_chars_result result = from_chars(p, last, value);
+    if (result.ec != errc()) return false;   // no digits, or out of range
+    p = result.ptr;
+    return true;
+}
+
+// Parse one text command line [p, last): a command letter and up to two
+// integers. Returns false for blank and comment lines; anything left over
+// after the arguments makes the command '?' (malformed)
+inline bool parseCommand(const char* p, const char* last, char& type, long long args[2], int& argc) {
+    while (p < last && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    if (p == last || *p == '#') return false;
+    
+    type = *p++;
+    argc = 0;
+    // The letter and each number must end at a blank or the end of the line
+    auto separated = [&] { return p == last || *p == ' ' || *p == '\t' || *p == '\r'; };
+    while (argc < 2 && separated() && parseInt(p, last, args[argc])) argc++;
+    while (p < last && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    if (p != last) type = '?';
+    return true;
+}
+
+// DSA: Command input that bypasses iostream. A regular file on stdin is
+// mapped whole; pipes and terminals are read in large blocks. Lines are
+// handed out in place and numbered, so errors can name the line.
+class CommandScanner {
+private:
+    FILE* input;
+    MappedFile mapping;
+    vector<char> buffer;
+    const char* data;            // mapped input or buffer.data()
+    size_t begin, end;           // unread bytes are data[begin, end)
+    bool eof;
+    size_t lineNumber;
+    
+    // Read another block after the unread bytes; false at end of input
+    bool refill() {
+        if (eof) return false;
+        if (begin > 0) {
+            memmove(buffer.data(), buffer.data() + begin, end - begin);
+            end -= begin;
+            begin = 0;
+        }
+        if (end == buffer.size()) buffer.resize(buffer.size() * 2);
+#if defined(__unix__) || defined(__APPLE__)
+        ssize_t got;
+        do {
+            got = ::read(fileno(input), buffer.data() + end, buffer.size() - end);
+        } while (got < 0 && errno == EINTR);
+        if (got <= 0) got = 0;
+#else
+        size_t got = fread(buffer.data() + end, 1, buffer.size() - end, input);
+#endif
+        data = buffer.data();
+        if (got == 0) {
+            eof = true;
+            return false;
+        }
+        end += (size_t)got;
+        return true;
+    }
+    
+public:
+    explicit CommandScanner(FILE* source = stdin)
+        : input(source), buffer(1 << 16), data(buffer.data()), begin(0), end(0), eof(false), lineNumber(0) {
+#if defined(__unix__) || defined(__APPLE__)
+        off_t offset = lseek(fileno(input), 0, SEEK_CUR);
+        if (offset >= 0 && mapping.map(fileno(input)) && (size_t)offset <= mapping.size()) {
+            data = (const char*)mapping.data();
+            begin = (size_t)offset;
+            end = mapping.size();
+            eof = true;
+        }
+#endif
+    }
+    
+    // Next non-blank line as [line, last) without the newline and leading
+    // blanks; false at end of input
+    bool nextLine(const char*& line, const char*& last) {
+        while (true) {
+            const char* newline = (const char*)memchr(data + begin, '\n', end - begin);
+            while (!newline && refill()) {
+                newline = (const char*)memchr(data + begin, '\n', end - begin);
+            }
+            if (!newline && begin == end) return false;
+            line = data + begin;
+            last = newline ? newline : data + end;
+            begin = (size_t)(last - data) + (newline ? 1 : 0);
+            lineNumber++;
+            while (line < last && (*line == ' ' || *line == '\t' || *line == '\r')) line++;
+            while (last > line && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r')) last--;
+            if (line < last) return true;
+        }
+    }
+    
+    // Next whitespace-separated word of a line, advancing p
+    static bool parseWord(const char*& p, const char* last, string& word) {
+        while (p < last && (*p == ' ' || *p == '\t')) p++;
+        const char* start = p;
+        while (p < last && *p != ' ' && *p != '\t') p++;
+        word.assign(start, p);
+        return p > start;
+    }
+    
+    // Next line as a single number (prompts); false if it is anything else
+    bool nextNumber(long long& value) {
+        const char* p;
+        const char* last;
+        return nextLine(p, last) && parseInt(p, last, value) && atEnd(p, last);
+    }
+    
+    static bool atEnd(const char*& p, const char* last) {
+        while (p < last && (*p == ' ' || *p == '\t')) p++;
+        return p == last;
+    }
+    
+    size_t line() const { return lineNumber; }
+};
+
+// DSA: Best-time leaderboard of one board preset. The TOP_K fastest wins
+// are kept exactly in a sorted flat array (binary search, then a shift);
+// every win is also counted in a log-linear histogram of solve times
+// indexed by a Fenwick tree, so the rank of any time and the time at any
+// percentile are O(log buckets) prefix sums in fixed memory (about 21 KB)
+// however many results are recorded. Outside the top K a rank is exact to
+// within one bucket, i.e. to within 1/SUB_BUCKETS of the time.
+class Leaderboard {
+public:
+    struct Entry {
+        double seconds;      // solve time, first move to last
+        int boardValue;      // 3BV of the board
+        uint64_t seed;
+    };
+    
+    static const int TOP_K = 64;
+    
+private:
+    // Bucket of a time in microseconds: exact below SUB_BUCKETS, then
+    // SUB_BUCKETS buckets per power of two up to about two years
+    static const int SUB_BITS = 6;
+    static const int SUB_BUCKETS = 1 << SUB_BITS;
+    static const int OCTAVES = 40;
+    static const int BUCKETS = SUB_BUCKETS * (OCTAVES + 1);
+    
+    vector<Entry> best;              // ascending seconds, at most TOP_K
+    vector<uint64_t> tree;           // Fenwick tree of bucket counts, 1-based
+    uint64_t total = 0;
+    
+    static int bucketOf(double seconds) {
+        double micros = seconds * 1e6;
+        uint64_t value = micros <= 0 ? 0 : micros >= 0x1p46 ? (1ULL << 46) - 1 : (uint64_t)micros;
+        if (value < (uint64_t)SUB_BUCKETS) return (int)value;
+        int top = highestBit64(value);
+        return (top - SUB_BITS + 1) * SUB_BUCKETS + (int)(value >> (top - SUB_BITS)) - SUB_BUCKETS;
+    }
+    
+    // Midpoint of a bucket, in seconds
+    static double bucketSeconds(int bucket) {
+        int octave = bucket / SUB_BUCKETS, sub = bucket % SUB_BUCKETS;
+        if (octave == 0) return (sub + 0.5) * 1e-6;
+        double low = (double)((uint64_t)(SUB_BUCKETS + sub) << (octave - 1));
+        return (low + (double)(1ULL << (octave - 1)) / 2) * 1e-6;
+    }
+    
+    // Wins in buckets [0, bucket)
+    uint64_t countBelow(int bucket) const {
+        uint64_t sum = 0;
+        for (int i = bucket; i > 0; i -= i & -i) sum += tree[i];
+        return sum;
+    }
+    
+public:
+    Leaderboard() : tree(BUCKETS + 1, 0) {}
+    
+    // Record one win; returns its rank among the wins so far
+    uint64_t record(const Entry& entry) {
+        uint64_t rank = rankOf(entry.seconds);
+        for (int i = bucketOf(entry.seconds) + 1; i <= BUCKETS; i += i & -i) tree[i]++;
+        total++;
+        if (best.size() < (size_t)TOP_K || entry.seconds < best.back().seconds) {
+            auto at = upper_bound(best.begin(), best.end(), entry.seconds,
+                                  [](double seconds, const Entry& e) { return seconds < e.seconds; });
+            if (best.size() == (size_t)TOP_K) best.pop_back();
+            best.insert(at, entry);
+        }
+        return rank;
+    }
+    
+    // 1 + the number of recorded wins strictly faster than seconds
+    uint64_t rankOf(double seconds) const {
+        auto at = lower_bound(best.begin(), best.end(), seconds,
+                              [](const Entry& e, double value) { return e.seconds < value; });
+        if (at != best.end() || total == best.size()) return (uint64_t)(at - best.begin()) + 1;
+        return max(countBelow(bucketOf(seconds)), (uint64_t)best.size()) + 1;
+    }
+    
+    // Share of recorded wins, in percent, that were no faster than seconds
+    double percentileOf(double seconds) const {
+        return total == 0 ? 100.0 : 100.0 * (double)(total - (rankOf(seconds) - 1)) / (double)total;
+    }
+    
+    // Time within which percent of the recorded wins were solved
+    double secondsAtPercentile(double percent) const {
+        if (total == 0) return 0;
+        uint64_t k = (uint64_t)ceil(percent / 100 * (double)total);
+        k = min(max(k, (uint64_t)1), total);
+        if (k <= best.size()) return best[k - 1].seconds;
+        
+        // Fenwick descent: the last bucket with fewer than k wins below it
+        int bucket = 0;
+        uint64_t seen = 0;
+        for (int step = 1 << 11; step > 0; step >>= 1) {
+            if (bucket + step <= BUCKETS && seen + tree[bucket + step] < k) {
+                bucket += step;
+                seen += tree[bucket];
+            }
+        }
+        return bucketSeconds(bucket);
+    }
+    
+    const vector<Entry>& top() const { return best; }
+    uint64_t count() const { return total; }
+};
+
+// One leaderboard per standard preset; custom boards are not ranked
+class LeaderboardService {
+private:
+    Leaderboard boards[3];
+    
+public:
+    // 0-2 for beginner, intermediate and expert, -1 for anything else
+    static int presetOf(int rows, int cols, int mines) {
+        if (rows == 9 && cols == 9 && mines == 10) return 0;
+        if (rows == 16 && cols == 16 && mines == 40) return 1;
+        if (rows == 16 && cols == 30 && mines == 99) return 2;
+        return -1;
+    }
+    
+    static const char* presetName(int preset) {
+        static const char* names[3] = {"beginner", "intermediate", "expert"};
+        return names[preset];
+    }
+    
+    // Leaderboard of a rows x cols board; nullptr for custom sizes
+    Leaderboard* find(int rows, int cols, int mines) {
+        int preset = presetOf(rows, cols, mines);
+        return preset < 0 ? nullptr : &boards[preset];
+    }
+};
+
+class Minesweeper {
+private:
+    int rows, cols, totalMines;
+    uint64_t seed;                   // seed the mine layout was generated from
+    Xoshiro256 rng;
+    int stride;                      // cols + 2 (one padding column on each side)
+    vector<uint8_t> cells;           // (rows + 2) x (cols + 2) padded cell array
+    bool gameOver;
+    bool gameWon;
+    GameStats stats;
+    mutable TerminalRenderer renderer;
+    
+    // Index offsets of the 8 adjacent cells (including diagonals)
+    int neighborOffset[8];
+    
+    vector<int> mineCells;           // board indices of every mine (generation scratch)
+    StartMode startMode;             // safe/no-guess modes defer mines to the first reveal
+    bool generated;                  // mines placed and numbered
+    GenerationReport report;
+    mutable int boardValue;          // 3BV, computed on first request (-1 until then)
+    mutable vector<int> valueScratch[2];
+    
+    // Solve clock: runs from the first applied move until the game ends,
+    // so time spent after a loss that is then undone is not counted
+    chrono::steady_clock::time_point clockStarted;
+    double playedSeconds;
+    bool clockRunning;
+    bool assisted;                   // undo or load used: the time is not ranked
+    
+    // Flood fill scratch space, reused across moves
+    vector<int> fillStack;           // seeds of zero spans still to expand
+    vector<int> lastChanged;         // cells changed by the last move
+    MoveJournal journal;             // applied moves for undo/redo and replay
+    Frontier frontier;               // maintained once trackFrontier() is called
+    bool trackingFrontier = false;
+    
+    void markRevealed(int idx) {
+        cells[idx] |= REVEALED_BIT;
+        if (trackingFrontier) frontier.revealed(cells.data(), idx);
+        lastChanged.push_back(idx);
+        stats.cellsRevealed++;
+        if (!(cells[idx] & MINE_BIT)) stats.safeRevealed++;
+    }
+    
+public:
+    Minesweeper(int r, int c, int mines, uint64_t boardSeed = randomSeed(), StartMode start = START_ANYWHERE)
+        : rows(r), cols(c), totalMines(mines), seed(boardSeed), rng(boardSeed),
+          startMode(start), generated(false), report{0, 0, 0, false, 0.0} {
+        resize(r, c, mines);
+        generate(boardSeed);
+    }
+    
+    // Start over with a new layout on the existing storage (no allocation)
+    void reset(uint64_t boardSeed) {
+        report = GenerationReport{0, 0, 0, false, 0.0};
+        generate(boardSeed);
+        renderer.invalidate();
+    }
+    
+    // Start a game with new settings; storage is only reallocated when the
+    // board grows beyond its current capacity
+    void newGame(int r, int c, int mines, uint64_t boardSeed, StartMode start) {
+        if (r != rows || c != cols) {
+            resize(r, c, mines);
+            renderer.attach(rows, cols);
+        }
+        totalMines = mines;
+        startMode = start;
+        reset(boardSeed);
+    }
+    
+    // Initialize the padded board for new dimensions (contents undefined
+    // until the next clearBoard)
+    void resize(int r, int c, int mines) {
+        rows = r;
+        cols = c;
+        totalMines = mines;
+        stride = cols + 2;
+        cells.resize(boardBytes(rows, cols));
+        initBoardCells(cells.data(), rows, cols);
+        
+        int k = 0;
+        for (int ddx = -1; ddx <= 1; ddx++) {
+            for (int ddy = -1; ddy <= 1; ddy++) {
+                if (ddx != 0 || ddy != 0) {
+                    neighborOffset[k++] = ddx * stride + ddy;
+                }
+            }
+        }
+    }
+    
+    // Clear every playable cell and restart the counters and generator.
+    // The border ring is rebuilt too: sparse numbering bumps the counts of
+    // border cells, and over many resets those would carry into their flags.
+    void clearBoard(uint64_t boardSeed) {
+        initBoardCells(cells.data(), rows, cols);
+        mineCells.clear();
+        lastChanged.clear();
+        journal.clear();
+        seed = boardSeed;
+        rng.reseed(boardSeed);
+        gameOver = false;
+        gameWon = false;
+        stats = GameStats{0, 0, 0, 0, rows * cols - totalMines};
+        boardValue = -1;
+        playedSeconds = 0;
+        clockRunning = false;
+        assisted = false;
+        if (trackingFrontier) frontier.attach(view());
+    }
+    
+    // Build a fresh board from a seed on the existing storage
+    // With a safe start the mines are only placed by the first reveal
+    void generate(uint64_t boardSeed) {
+        clearBoard(boardSeed);
+        generated = false;
+        if (startMode != START_ANYWHERE) {
+            return;
+        }
+        
+        // Place mines randomly
+        placeMines();
+        
+        // Calculate numbers for each cell
+        calculateNumbers();
+        generated = true;
+    }
+    
+    // Lazy generation for a safe first click: place and number the mines as
+    // usual, then move any mine out of the clicked cell's 3x3 neighborhood
+    // (just the cell itself when the board is too full), fixing up counts
+    // locally around each moved mine
+    void generateAround(int clicked) {
+        placeMines();
+        calculateNumbers();
+        generated = true;
+        clearStartZone(cells.data(), rows, cols, neighborOffset, clicked, mineCells.data(), (int)mineCells.size(), rng);
+        
+        // Flags placed before the board existed may now sit on mines
+        if (stats.flagsPlaced > 0) {
+            stats.correctFlags += countFlaggedMines(cells.data(), mineCells.data(), (int)mineCells.size());
+        }
+    }
+    
+    // Throw the current layout away and deal a new safe-start one, as a
+    // no-guess dead end does. initBoardCells also rebuilds the border ring,
+    // whose counts sparse numbering has bumped.
+    void redealAround(int clicked) {
+        initBoardCells(cells.data(), rows, cols);
+        mineCells.clear();
+        generateAround(clicked);
+    }
+    
+    // DSA: No-guess generation. Start from a safe-start board and let the
+    // solver play it from the clicked cell. Whenever deduction gets stuck,
+    // repair locally: move one mine from the stuck frontier to an unknown
+    // cell that touches no revealed number, requeue the affected numbers
+    // and carry on. Every solver fact stays true across a repair, but the
+    // earlier deductions used the old numbers, so a pass that needed
+    // repairs is followed by a clean verification pass from the start.
+    void generateNoGuess(int clicked) {
+        const int MAX_PASSES = 64;
+        auto started = chrono::steady_clock::now();
+        report = GenerationReport{0, 0, 0, false, 0.0};
+        
+        // Flags placed before the first click would block the simulated fills
+        vector<int> savedFlags;
+        if (stats.flagsPlaced > 0) {
+            for (int i = 0; i < rows; i++) {
+                for (int j = 0; j < cols; j++) {
+                    if (isFlagged(i, j)) {
+                        savedFlags.push_back(index(i, j));
+                        cells[index(i, j)] &= ~FLAGGED_BIT;
+                    }
+                }
+            }
+            stats.flagsPlaced = stats.correctFlags = 0;
+        }
+        
+        generateAround(clicked);
+        Solver solver;
+        while (report.passes < MAX_PASSES) {
+            report.passes++;
+            int repairs = 0, looseRepairs = 0;
+            bool deadEnd = false;
+            
+            solver.attach(view());
+            lastChanged.clear();
+            revealIndex(clicked);
+            solver.update(lastChanged);
+            while (stats.safeRevealed < stats.safeCells) {
+                int safe = solver.nextSafe();
+                if (safe >= 0) {
+                    lastChanged.clear();
+                    revealIndex(safe);
+                    solver.update(lastChanged);
+                } else if (repairs < rows * cols && repairStuck(solver, looseRepairs)) {
+                    repairs++;
+                } else {
+                    deadEnd = true;
+                    break;
+                }
+            }
+            report.repairs += repairs;
+            hideAll();
+            
+            if (deadEnd) {
+                // No local fix left: draw a whole new layout and start over
+                redealAround(clicked);
+                report.regenerations++;
+            } else if (repairs == 0) {
+                report.solvable = true;
+                break;
+            }
+        }
+        
+        for (int idx : savedFlags) {
+            cells[idx] |= FLAGGED_BIT;
+            stats.flagsPlaced++;
+            if (cells[idx] & MINE_BIT) stats.correctFlags++;
+        }
+        report.seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    }
+    
+    // Move one mine out of the stuck frontier into another unknown cell
+    bool repairStuck(Solver& solver, int& looseRepairs) {
+        const int MAX_LOOSE_REPAIRS = 4;
+        const vector<int>& numbers = solver.frontierNumbers();
+        if (numbers.empty()) return false;
+        
+        int from = -1;
+        size_t first = rng.nextBelow((uint32_t)numbers.size());
+        for (size_t n = 0; n < numbers.size() && from < 0; n++) {
+            int unknown[8];
+            int count = solver.unknownAround(numbers[(first + n) % numbers.size()], unknown);
+            for (int i = 0; i < count && from < 0; i++) {
+                if (cells[unknown[i]] & MINE_BIT) from = unknown[i];
+            }
+        }
+        if (from < 0) return false;
+        
+        // Prefer a cell that touches no revealed number, so only the stuck
+        // frontier's numbers change; late in the board settle for any unknown
+        // cell a few times per pass (more would just shuffle mines around)
+        auto candidate = [&](int idx, bool needIsolated) {
+            if (idx == from || (cells[idx] & (MINE_BIT | REVEALED_BIT)) || solver.isKnown(idx)) return false;
+            for (int k = 0; k < 8 && needIsolated; k++) {
+                int n = idx + neighborOffset[k];
+                if ((cells[n] & (REVEALED_BIT | BORDER_BIT)) == REVEALED_BIT) return false;
+            }
+            return true;
+        };
+        int total = rows * cols;
+        int target = -1;
+        for (int attempt = 0; attempt < 64 && target < 0; attempt++) {
+            int k = (int)rng.nextBelow((uint32_t)total);
+            if (candidate(index(k / cols, k % cols), true)) target = index(k / cols, k % cols);
+        }
+        for (int pass = 0; pass < (looseRepairs < MAX_LOOSE_REPAIRS ? 2 : 1) && target < 0; pass++) {
+            int k = (int)rng.nextBelow((uint32_t)total);
+            for (int n = 0; n < total && target < 0; n++, k = (k + 1) % total) {
+                if (candidate(index(k / cols, k % cols), pass == 0)) target = index(k / cols, k % cols);
+            }
+        }
+        if (target < 0) return false;
+        if (!candidate(target, true)) looseRepairs++;
+        
+        relocateMine(cells.data(), neighborOffset, mineCells.data(), (int)mineCells.size(), from, target);
+        solver.touch(from);
+        solver.touch(target);
+        return true;
+    }
+    
+    // Undo a simulation: hide every revealed cell again
+    void hideAll() {
+        for (int i = 0; i < rows; i++) {
+            int idx = index(i, 0);
+            for (int j = 0; j < cols; j++, idx++) {
+                cells[idx] &= ~REVEALED_BIT;
+            }
+        }
+        stats.cellsRevealed = stats.safeRevealed = 0;
+        lastChanged.clear();
+        gameOver = false;
+        if (trackingFrontier) frontier.attach(view());
+    }
+    
+    // DSA: Floyd's sampling algorithm - a uniform random subset of
+    // totalMines cells in O(mines), using the board itself as the set
+    void placeMines() {
+        MS_TIMED(PLACE_MINES);
+        placeMinesFloyd(cells.data(), rows, cols, totalMines, rng, mineCells);
+    }
+    
+    // DSA: Graph traversal to calculate adjacent mine counts
+    // Expects all counts to be zero (freshly placed board)
+    void calculateNumbers() {
+        MS_TIMED(CALCULATE_NUMBERS);
+        numberBoard(cells.data(), rows, cols, mineCells);
+    }
+    
+    // Helper function to check if coordinates are valid
+    bool isValid(int x, int y) const {
+        return x >= 0 && x < rows && y >= 0 && y < cols;
+    }
+    
+    // Cell accessors (coordinates must be valid)
+    int index(int x, int y) const { return (x + 1) * stride + (y + 1); }
+    bool isMine(int x, int y) const { return cells[index(x, y)] & MINE_BIT; }
+    bool isRevealed(int x, int y) const { return cells[index(x, y)] & REVEALED_BIT; }
+    bool isFlagged(int x, int y) const { return cells[index(x, y)] & FLAGGED_BIT; }
+    int adjacentMines(int x, int y) const { return cells[index(x, y)] & COUNT_MASK; }
+    
+    // DSA: Flood Fill Algorithm using an explicit scanline worklist
+    // Returns the board indices of every newly revealed cell
+    const vector<int>& revealCell(int x, int y) {
+        MS_TIMED(REVEAL_CELL);
+        lastChanged.clear();
+        if (!isValid(x, y)) {
+            return lastChanged;
+        }
+        if (!generated && !(cells[index(x, y)] & FLAGGED_BIT)) {
+            if (startMode == START_NO_GUESS) {
+                generateNoGuess(index(x, y));
+            } else {
+                generateAround(index(x, y));
+            }
+        }
+        revealIndex(index(x, y));
+        MS_RECORD_SIZE(REVEAL_CELL, lastChanged.size());
+        return lastChanged;
+    }
+    
+    // Flood fill from idx (see floodReveal)
+    void revealIndex(int idx) {
+        if (floodReveal(cells.data(), stride, idx, fillStack, [this](int cell) { markRevealed(cell); })) {
+            gameOver = true;
+        }
+    }
+    
+    // Chord on (x, y) (see chordReveal); returns the combined delta like revealCell
+    const vector<int>& chordCell(int x, int y) {
+        MS_TIMED(REVEAL_CELL);
+        lastChanged.clear();
+        if (!isValid(x, y)) {
+            return lastChanged;
+        }
+        if (chordReveal(cells.data(), stride, neighborOffset, index(x, y), fillStack,
+                        [this](int cell) { markRevealed(cell); })) {
+            gameOver = true;
+        }
+        MS_RECORD_SIZE(REVEAL_CELL, lastChanged.size());
+        return lastChanged;
+    }
+    
+    // Row index / column index of a board index returned by revealCell
+    int rowOf(int idx) const { return idx / stride - 1; }
+    int colOf(int idx) const { return idx % stride - 1; }
+    
+    // Toggle flag on a cell
+    void toggleFlag(int x, int y) {
+        lastChanged.clear();
+        if (!isValid(x, y) || isRevealed(x, y)) {
+            return;
+        }
+        
+        flipFlag(index(x, y));
+    }
+    
+    void flipFlag(int idx) {
+        lastChanged.push_back(idx);
+        uint8_t& cell = cells[idx];
+        cell ^= FLAGGED_BIT;
+        if (trackingFrontier) frontier.flagChanged(cells.data(), idx);
+        int delta = (cell & FLAGGED_BIT) ? 1 : -1;
+        stats.flagsPlaced += delta;
+        if (cell & MINE_BIT) stats.correctFlags += delta;
+    }
+    
+    // Headless entry point: apply one move without any I/O
+    MoveResult applyMove(const Move& move) {
+        lastChanged.clear();
+        MoveStatus status;
+        if (gameOver || gameWon) {
+            status = MOVE_GAME_ENDED;
+        } else if ((move.type != 'r' && move.type != 'f' && move.type != 'c') || !isValid(move.x, move.y)) {
+            status = MOVE_INVALID;
+        } else {
+            if (move.type == 'r') {
+                revealCell(move.x, move.y);
+            } else if (move.type == 'c') {
+                chordCell(move.x, move.y);
+            } else {
+                toggleFlag(move.x, move.y);
+            }
+            status = lastChanged.empty() ? MOVE_NO_CHANGE : MOVE_APPLIED;
+            if (status == MOVE_APPLIED) {
+                journal.record(move, lastChanged);
+                if (!clockRunning) {
+                    clockStarted = chrono::steady_clock::now();
+                    clockRunning = true;
+                }
+            }
+            checkWin();
+            if (clockRunning && (gameOver || gameWon)) {
+                playedSeconds += chrono::duration<double>(chrono::steady_clock::now() - clockStarted).count();
+                clockRunning = false;
+            }
+        }
+        return MoveResult{status, gameOver, gameWon, &lastChanged};
+    }
+    
+    // Roll back the last applied move by hiding (or unflagging) exactly the
+    // cells it changed; also reopens a lost or won game. The mine layout
+    // made by a deferred first reveal is kept.
+    bool undo() {
+        lastChanged.clear();
+        if (!journal.canUndo()) return false;
+        const MoveJournal::Entry& entry = journal.stepBack();
+        const int* changed = journal.cellsOf(entry);
+        for (size_t i = 0, n = entry.end - entry.begin; i < n; i++) {
+            int idx = changed[i];
+            if (entry.move.type == 'f') {
+                flipFlag(idx);
+                continue;
+            }
+            cells[idx] &= ~REVEALED_BIT;
+            if (trackingFrontier) frontier.hidden(cells.data(), idx);
+            lastChanged.push_back(idx);
+            stats.cellsRevealed--;
+            if (!(cells[idx] & MINE_BIT)) stats.safeRevealed--;
+        }
+        // Only the final move of a game can have revealed a mine
+        gameOver = false;
+        gameWon = false;
+        assisted = true;
+        return true;
+    }
+    
+    // Re-apply the next undone move from its recorded cells
+    bool redo() {
+        lastChanged.clear();
+        if (!journal.canRedo()) return false;
+        const MoveJournal::Entry& entry = journal.stepForward();
+        const int* changed = journal.cellsOf(entry);
+        for (size_t i = 0, n = entry.end - entry.begin; i < n; i++) {
+            int idx = changed[i];
+            if (entry.move.type == 'f') {
+                flipFlag(idx);
+            } else {
+                markRevealed(idx);
+                if (cells[idx] & MINE_BIT) gameOver = true;
+            }
+        }
+        checkWin();
+        return true;
+    }
+    
+    // Write the applied moves as a text move stream for --batch; the
+    // header comment lists the options that reproduce this board
+    bool writeReplay(const string& path) const {
+        FILE* out = fopen(path.c_str(), "w");
+        if (!out) return false;
+        fprintf(out, "# --rows %d --cols %d --mines %d --seed %llu%s\n", rows, cols, totalMines,
+                (unsigned long long)seed,
+                startMode == START_SAFE ? " --safe-start" : startMode == START_NO_GUESS ? " --no-guess" : "");
+        for (size_t i = 0; i < journal.appliedCount(); i++) {
+            const Move& move = journal.applied(i);
+            fprintf(out, "%c %d %d\n", move.type, move.x, move.y);
+        }
+        fprintf(out, "q\n");
+        return fclose(out) == 0;
+    }
+    
+    // Check if game is won (O(1) using the running counters)
+    bool checkWin() {
+        MS_TIMED(CHECK_WIN);
+        // Win condition: all non-mine cells revealed
+        if (stats.safeRevealed == stats.safeCells) {
+            gameWon = true;
+            return true;
+        }
+        
+        return false;
+    }
+    
+    // Read-only view of the board for renderers
+    BoardView view() const {
+        return BoardView{rows, cols, stride, cells.data(), trackingFrontier ? &frontier : nullptr};
+    }
+    
+    // Keep the frontier up to date from now on (costs one rebuild, then
+    // only the neighbors of each changed cell); view() then carries it
+    void trackFrontier() {
+        if (trackingFrontier) return;
+        trackingFrontier = true;
+        frontier.attach(view());
+    }
+    
+    // Display the game grid
+    void displayGrid(bool showMines = false) const {
+        renderer.drawFull(view(), showMines, "");
+    }
+    
+    // Game statistics line
+    string statsLine() const {
+        return "Mines: " + to_string(totalMines) + " | Flags Used: " + to_string(stats.flagsPlaced)
+             + " | Cells Revealed: " + to_string(stats.cellsRevealed) + "/" + to_string(stats.safeCells) + "\n";
+    }
+    
+    // Display game statistics
+    void displayStats() const {
+        cout << statsLine();
+    }
+    
+    // Encode the game in the save format (see SAVE_VERSION) into out
+    void serialize(vector<uint8_t>& out, bool rle) const {
+        const uint8_t planes[3] = {MINE_BIT, REVEALED_BIT, FLAGGED_BIT};
+        size_t cellCount = (size_t)rows * cols;
+        size_t planeBytes = (cellCount + 7) / 8;
+        out.assign(SAVE_HEADER_BYTES, 0);
+        out.reserve(SAVE_HEADER_BYTES + 3 * planeBytes);
+        
+        for (uint8_t bit : planes) {
+            if (!rle) {
+                // Bits are gathered in a register and stored a byte at a time
+                size_t base = out.size();
+                out.resize(base + planeBytes, 0);
+                uint8_t* packed = &out[base];
+                unsigned acc = 0, used = 0;
+                for (int i = 0; i < rows; i++) {
+                    const uint8_t* row = &cells[index(i, 0)];
+                    for (int j = 0; j < cols; j++) {
+                        acc |= (unsigned)((row[j] & bit) != 0) << used;
+                        if (++used == 8) {
+                            *packed++ = (uint8_t)acc;
+                            acc = used = 0;
+                        }
+                    }
+                }
+                if (used > 0) *packed = (uint8_t)acc;
+                continue;
+            }
+            bool current = false;
+            uint64_t run = 0;
+            for (int i = 0; i < rows; i++) {
+                const uint8_t* row = &cells[index(i, 0)];
+                for (int j = 0; j < cols; j++) {
+                    if (((row[j] & bit) != 0) != current) {
+                        putVarint(out, run);
+                        current = !current;
+                        run = 0;
+                    }
+                    run++;
+                }
+            }
+            putVarint(out, run);
+        }
+        
+        uint8_t* header = out.data();
+        memcpy(header, "MSSV", 4);
+        putLE(header + 4, SAVE_VERSION, 2);
+        putLE(header + 6, rle ? SAVE_RLE : 0, 2);
+        putLE(header + 8, (uint32_t)rows, 4);
+        putLE(header + 12, (uint32_t)cols, 4);
+        putLE(header + 16, (uint32_t)totalMines, 4);
+        header[20] = (uint8_t)startMode;
+        header[21] = generated ? 1 : 0;
+        putLE(header + 24, seed, 8);
+        size_t payload = out.size() - SAVE_HEADER_BYTES;
+        putLE(header + 32, payload, 8);
+        putLE(header + 40, fnv1a(header + SAVE_HEADER_BYTES, payload), 8);
+    }
+    
+    // Restore a game from a save image; on failure the game is unchanged
+    // and error says why
+    bool deserialize(const uint8_t* data, size_t size, string& error) {
+        if (size < SAVE_HEADER_BYTES || memcmp(data, "MSSV", 4) != 0) {
+            error = "not a save file";
+            return false;
+        }
+        uint16_t flags = (uint16_t)getLE(data + 6, 2);
+        if (getLE(data + 4, 2) != SAVE_VERSION || (flags & ~SAVE_RLE) != 0) {
+            error = "unsupported save version";
+            return false;
+        }
+        int r = (int)getLE(data + 8, 4), c = (int)getLE(data + 12, 4), mines = (int)getLE(data + 16, 4);
+        if (!validSettings(r, c, mines) || data[20] > START_NO_GUESS) {
+            error = "invalid board settings";
+            return false;
+        }
+        const uint8_t* payload = data + SAVE_HEADER_BYTES;
+        uint64_t payloadBytes = getLE(data + 32, 8);
+        if (payloadBytes != size - SAVE_HEADER_BYTES || fnv1a(payload, payloadBytes) != getLE(data + 40, 8)) {
+            error = "truncated or corrupt save file";
+            return false;
+        }
+        
+        // Decode the planes into scratch first so a bad file leaves us intact
+        size_t cellCount = (size_t)r * c;
+        vector<uint8_t> state(cellCount, 0);
+        const uint8_t planes[3] = {MINE_BIT, REVEALED_BIT, FLAGGED_BIT};
+        const uint8_t* in = payload;
+        const uint8_t* end = payload + payloadBytes;
+        for (uint8_t bit : planes) {
+            if (!(flags & SAVE_RLE)) {
+                size_t planeBytes = (cellCount + 7) / 8;
+                if ((size_t)(end - in) < planeBytes) {
+                    error = "truncated save file";
+                    return false;
+                }
+                for (size_t k = 0; k < cellCount; k += 8) {
+                    unsigned byte = in[k >> 3];
+                    size_t count = min((size_t)8, cellCount - k);
+                    for (size_t b = 0; b < count; b++) {
+                        state[k + b] |= (uint8_t)((byte >> b & 1) * bit);
+                    }
+                }
+                in += planeBytes;
+                continue;
+            }
+            bool current = false;
+            size_t k = 0;
+            while (k < cellCount) {
+                uint64_t run;
+                if (!getVarint(in, end, run) || run > cellCount - k) {
+                    error = "corrupt run-length data";
+                    return false;
+                }
+                if (current) {
+                    for (size_t n = 0; n < run; n++) state[k + n] |= bit;
+                }
+                k += run;
+                current = !current;
+            }
+        }
+        
+        size_t mineCount = 0;
+        for (uint8_t cell : state) mineCount += (cell & MINE_BIT) != 0;
+        bool isGenerated = data[21] != 0;
+        if (mineCount != (isGenerated ? (size_t)mines : 0)) {
+            error = "mine count does not match the header";
+            return false;
+        }
+        
+        if (r != rows || c != cols) {
+            resize(r, c, mines);
+            renderer.attach(rows, cols);
+        }
+        renderer.invalidate();
+        totalMines = mines;
+        startMode = (StartMode)data[20];
+        clearBoard(getLE(data + 24, 8));
+        assisted = true;             // the save does not carry the clock
+        generated = isGenerated;
+        report = GenerationReport{0, 0, 0, false, 0.0};
+        
+        size_t k = 0;
+        for (int i = 0; i < rows; i++) {
+            int idx = index(i, 0);
+            for (int j = 0; j < cols; j++, idx++, k++) {
+                cells[idx] = state[k];
+                if (state[k] & MINE_BIT) mineCells.push_back(idx);
+            }
+        }
+        if (generated) calculateNumbers();
+        
+        // Derive the counters and the game state from the restored cells
+        for (int idx = index(0, 0), last = index(rows - 1, cols - 1); idx <= last; idx++) {
+            uint8_t cell = cells[idx];
+            if (cell & BORDER_BIT) continue;
+            if (cell & REVEALED_BIT) {
+                stats.cellsRevealed++;
+                if (cell & MINE_BIT) gameOver = true;
+                else stats.safeRevealed++;
+            }
+            if (cell & FLAGGED_BIT) {
+                stats.flagsPlaced++;
+                if (cell & MINE_BIT) stats.correctFlags++;
+            }
+        }
+        if (trackingFrontier) frontier.attach(view());
+        gameWon = !gameOver && checkWin();
+        return true;
+    }
+    
+    // Write the game to a file in one call
+    bool save(const string& path, bool rle = false) const {
+        vector<uint8_t> image;
+        serialize(image, rle);
+        FILE* out = fopen(path.c_str(), "wb");
+        if (!out) return false;
+        bool ok = fwrite(image.data(), 1, image.size(), out) == image.size();
+        return fclose(out) == 0 && ok;
+    }
+    
+    // Resume a saved game; the file is mapped, not parsed
+    bool load(const string& path, string& error) {
+        MappedFile file;
+        if (!file.open(path)) {
+            error = "cannot open " + path;
+            return false;
+        }
+        return deserialize(file.data(), file.size(), error);
+    }
+    
+    // Main game loop
+    void playGame() {
+        CommandScanner input;
+        playGame(input);
+    }
+    
+    // Wins without undo, hints or a load are ranked on leaderboard, if given
+    void playGame(CommandScanner& input, LeaderboardService* leaderboard = nullptr) {
+        cout << "Welcome to Minesweeper!\n";
+        cout << "Commands:\n";
+        cout << "  r x y - Reveal cell at (x,y)\n";
+        cout << "  f x y - Flag/unflag cell at (x,y)\n";
+        cout << "  c x y - Chord: reveal the unflagged neighbors of a satisfied number\n";
+        cout << "  v x y - Scroll view to start at (x,y)\n";
+        cout << "  h     - Hint: show a provably safe cell\n";
+        cout << "  i     - Show operation counters and latencies\n";
+        cout << "  u     - Undo the last move\n";
+        cout << "  y     - Redo an undone move\n";
+        cout << "  s file - Save the game to a file\n";
+        cout << "  l file - Load a saved game\n";
+        cout << "  w file - Write the moves so far as a --batch replay\n";
+        cout << "  q     - Quit game\n\n";
+        
+        renderer.attach(rows, cols);
+        Solver solver;
+        bool solverAttached = false;   // attached on the first hint request
+        string message;
+        lastChanged.clear();
+        while (!gameOver && !gameWon) {
+            renderer.drawChanges(view(), lastChanged, statsLine() + message);
+            lastChanged.clear();
+            message.clear();
+            
+            cout << "Enter command: ";
+            cout.flush();
+            const char* p;
+            const char* last;
+            if (!input.nextLine(p, last)) {
+                cout << "\nThanks for playing!\n";   // end of input quits
+                return;
+            }
+            char command = *p;
+            long long args[2];
+            int argc = 0;
+            string where = " (line " + to_string(input.line()) + ")\n";
+            bool fileCommand = command == 's' || command == 'l' || command == 'w';
+            if (fileCommand) {
+                p++;
+                if (p < last && *p != ' ' && *p != '\t') {
+                    message = "Invalid command!" + where;
+                    continue;
+                }
+            } else if (!parseCommand(p, last, command, args, argc)) {
+                continue;   // comment line
+            }
+            bool coordinates = command == 'r' || command == 'f' || command == 'c' || command == 'v';
+            if (coordinates && argc != 2) {
+                message = "Expected two coordinates" + where;
+                continue;
+            }
+            if (!coordinates && !fileCommand && argc != 0) {
+                message = "Invalid command!" + where;
+                continue;
+            }
+            
+            if (command == 'q') {
+                cout << "Thanks for playing!\n";
+                return;
+            }
+            
+            if (command == 'h') {
+                assisted = true;
+                trackFrontier();
+                if (!solverAttached) {
+                    solver.attach(view());
+                    solverAttached = true;
+                }
+                int safe = solver.nextSafe();
+                int mine = solver.nextUnflaggedMine();
+                if (safe >= 0) {
+                    message = "Hint: (" + to_string(rowOf(safe)) + "," + to_string(colOf(safe)) + ") is safe\n";
+                } else if (mine >= 0) {
+                    message = "Hint: (" + to_string(rowOf(mine)) + "," + to_string(colOf(mine)) + ") is a mine\n";
+                } else {
+                    ProbabilityEstimator estimator(ProbabilityEstimator::Settings{
+                        (int)max(1u, thread::hardware_concurrency()), 0.005, 0.2, seed});
+                    estimator.estimate(view(), totalMines, &solver);
+                    int best = estimator.safestCell();
+                    char percent[16];
+                    snprintf(percent, sizeof(percent), "%.1f%%", best >= 0 ? estimator.probabilityAt(best) * 100 : 0.0);
+                    message = "Hint: no cell can be proven safe - the best guess is ("
+                            + to_string(rowOf(best)) + "," + to_string(colOf(best)) + "), " + percent + " mine chance\n";
+                }
+                continue;
+            }
+            
+            if (command == 'i') {
+                ostringstream statsText;
+                dumpInstrumentation(statsText, false);
+                message = statsText.str();
+                continue;
+            }
+            
+            if (command == 'u' || command == 'y') {
+                if (!(command == 'u' ? undo() : redo())) {
+                    message = command == 'u' ? "Nothing to undo\n" : "Nothing to redo\n";
+                }
+                solverAttached = false;   // the solver only tracks forward progress
+                continue;
+            }
+            
+            if (command == 's' || command == 'l' || command == 'w') {
+                string path;
+                if (!CommandScanner::parseWord(p, last, path) || !CommandScanner::atEnd(p, last)) {
+                    message = "Expected one file name" + where;
+                    continue;
+                }
+                string error;
+                if (command == 'w') {
+                    message = writeReplay(path) ? "Replay written to " + path + "\n"
+                                                : "Cannot write " + path + "\n";
+                } else if (command == 's') {
+                    message = save(path, totalMines * 8 < rows * cols) ? "Saved to " + path + "\n"
+                                                                       : "Cannot write " + path + "\n";
+                } else if (load(path, error)) {
+                    message = "Loaded " + path + "\n";
+                    solverAttached = false;
+                } else {
+                    message = "Load failed: " + error + "\n";
+                }
+                continue;
+            }
+            
+            if (command == 'r' || command == 'f' || command == 'c' || command == 'v') {
+                if (args[0] < 0 || args[0] >= rows || args[1] < 0 || args[1] >= cols) {
+                    message = "Invalid coordinates!" + where;
+                    continue;
+                }
+                int x = (int)args[0], y = (int)args[1];
+                
+                if (command == 'v') {
+                    renderer.scrollTo(view(), x, y);
+                    continue;
+                }
+                
+                renderer.ensureVisible(view(), x, y);
+                applyMove(Move{command, x, y});
+                if (solverAttached) {
+                    solver.update(lastChanged);
+                }
+            } else {
+                message = "Invalid command!" + where;
+            }
+        }
+        
+        // Game ended - show final state
+        displayGrid(true);
+        displayStats();
+        
+        if (gameWon) {
+            cout << "🎉 Congratulations! You won! 🎉\n";
+            double seconds = getPlaySeconds();
+            int value = getBoardValue();
+            char summary[96];
+            snprintf(summary, sizeof(summary), "Time: %.2fs | 3BV: %d | 3BV/s: %.2f\n", seconds, value,
+                     seconds > 0 ? value / seconds : 0.0);
+            cout << summary;
+            int preset = LeaderboardService::presetOf(rows, cols, totalMines);
+            if (leaderboard && preset >= 0 && !assisted) {
+                Leaderboard* board = leaderboard->find(rows, cols, totalMines);
+                uint64_t rank = board->record(Leaderboard::Entry{seconds, value, seed});
+                if (board->count() > 1) {
+                    cout << "Rank " << rank << " of " << board->count() << " ranked wins on "
+                         << LeaderboardService::presetName(preset) << " this session\n";
+                } else {
+                    cout << "First ranked win on " << LeaderboardService::presetName(preset) << " this session\n";
+                }
+            } else if (leaderboard && preset >= 0) {
+                cout << "Not ranked: undo, a hint or a load was used\n";
+            }
+        } else {
+            cout << "💥 Game Over! You hit a mine! 💥\n";
+        }
+    }
+    
+    // Get game state
+    bool isGameOver() const { return gameOver; }
+    bool isGameWon() const { return gameWon; }
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+    int getTotalMines() const { return totalMines; }
+    uint64_t getSeed() const { return seed; }
+    StartMode getStartMode() const { return startMode; }
+    bool isGenerated() const { return generated; }
+    const GenerationReport& getGenerationReport() const { return report; }
+    const GameStats& getStats() const { return stats; }
+    
+    // 3BV of the board (0 before the mines are placed)
+    int getBoardValue() const {
+        if (!generated) return 0;
+        if (boardValue < 0) boardValue = countBoardValue(cells.data(), rows, cols, valueScratch[0], valueScratch[1]);
+        return boardValue;
+    }
+    
+    // Seconds on the solve clock so far
+    double getPlaySeconds() const {
+        return playedSeconds + (clockRunning ? chrono::duration<double>(chrono::steady_clock::now() - clockStarted).count() : 0);
+    }
+    
+    bool isAssisted() const { return assisted; }
+};
+
+// Ask for another round after a finished game; end of input means no
+bool askPlayAgain(CommandScanner& input) {
+    cout << "Play again? (y/n): ";
+    cout.flush();
+    const char* p;
+    const char* last;
+    return input.nextLine(p, last) && (*p == 'y' || *p == 'Y');
+}
+
+// Function to get difficulty level
+void getDifficultySettings(int& rows, int& cols, int& mines, CommandScanner& input) {
+    cout << "Select difficulty:\n";
+    cout << "1. Beginner (9x9, 10 mines)\n";
+    cout << "2. Intermediate (16x16, 40 mines)\n";
+    cout << "3. Expert (30x16, 99 mines)\n";
+    cout << "4. Custom\n";
+    cout << "Enter choice (1-4): ";
+    
+    long long choice = 0;
+    input.nextNumber(choice);
+    
+    switch (choice) {
+        case 1:
+            rows = 9; cols = 9; mines = 10;
+            break;
+        case 2:
+            rows = 16; cols = 16; mines = 40;
+            break;
+        case 3:
+            rows = 16; cols = 30; mines = 99;
+            break;
+        case 4: {
+            long long value[3];
+            cout << "Enter rows: ";
+            cout.flush();
+            bool valid = input.nextNumber(value[0]);
+            cout << "Enter columns: ";
+            cout.flush();
+            valid = valid && input.nextNumber(value[1]);
+            cout << "Enter number of mines: ";
+            cout.flush();
+            valid = valid && input.nextNumber(value[2]);
+            
+            // Validate custom settings
+            if (valid && value[0] <= INT_MAX && value[1] <= INT_MAX && value[2] <= INT_MAX) {
+                rows = (int)value[0]; cols = (int)value[1]; mines = (int)value[2];
+            }
+            if (!valid || !validSettings(rows, cols, mines)) {
+                cout << "Invalid settings! Using beginner mode.\n";
+                rows = 9; cols = 9; mines = 10;
+            }
+            break;
+        }
+        default:
+            cout << "Invalid choice! Using beginner mode.\n";
+            rows = 9; cols = 9; mines = 10;
+    }
+}
+
+// DSA: Pool of reusable games, one free list per board configuration
+// (rows, cols, mines, start mode). acquire() hands out a recycled game reset
+// to a new seed and only constructs when that free list is empty, so a
+// service that churns through games stops allocating once warmed up.
+class GamePool {
+private:
+    struct Bucket {
+        int rows, cols, mines;
+        StartMode start;
+        vector<unique_ptr<Minesweeper>> free;
+    };
+    vector<Bucket> buckets;      // a handful of presets: linear search is fastest
+    size_t constructed;
+    
+    Bucket& bucketFor(int rows, int cols, int mines, StartMode start) {
+        for (Bucket& bucket : buckets) {
+            if (bucket.rows == rows && bucket.cols == cols && bucket.mines == mines && bucket.start == start) {
+                return bucket;
+            }
+        }
+        buckets.push_back(Bucket{rows, cols, mines, start, {}});
+        return buckets.back();
+    }
+    
+public:
+    GamePool() : constructed(0) {}
+    
+    // Preallocate count games of one configuration
+    void reserve(int rows, int cols, int mines, StartMode start, size_t count) {
+        Bucket& bucket = bucketFor(rows, cols, mines, start);
+        while (bucket.free.size() < count) {
+            bucket.free.emplace_back(new Minesweeper(rows, cols, mines, 0, start));
+            constructed++;
+        }
+    }
+    
+    unique_ptr<Minesweeper> acquire(int rows, int cols, int mines, uint64_t seed, StartMode start) {
+        Bucket& bucket = bucketFor(rows, cols, mines, start);
+        if (bucket.free.empty()) {
+            constructed++;
+            return unique_ptr<Minesweeper>(new Minesweeper(rows, cols, mines, seed, start));
+        }
+        unique_ptr<Minesweeper> game = move(bucket.free.back());
+        bucket.free.pop_back();
+        game->reset(seed);
+        return game;
+    }
+    
+    void release(unique_ptr<Minesweeper> game) {
+        if (!game) return;
+        Bucket& bucket = bucketFor(game->getRows(), game->getCols(), game->getTotalMines(), game->getStartMode());
+        bucket.free.push_back(move(game));
+    }
+    
+    size_t constructedCount() const { return constructed; }
+};
+
+// DSA: Versioned board snapshots for readers on other threads. A snapshot
+// is immutable: the board is cut into 32x32 tiles and a snapshot holds one
+// shared pointer per tile. Publishing after a move copies only the tiles
+// the move touched, shares the rest with the previous snapshot and swaps
+// the current pointer atomically (copy-on-write). Old snapshots are
+// reclaimed by epochs: a reader announces the epoch it saw before loading
+// the pointer, and a snapshot retired at epoch R is freed once no reader
+// announces an epoch below R. Readers take no lock and never touch the
+// tile reference counts; the single writer never waits for them.
+class SnapshotPublisher {
+public:
+    static const int TILE = 32;
+    static const int MAX_READERS = 64;
+    
+    struct Tile {
+        uint8_t cells[TILE * TILE];      // same encoding as the board, row-major
+    };
+    
+    struct Snapshot {
+        uint64_t version;                // publishes before this one
+        int rows, cols, mines;
+        uint64_t seed;
+        bool gameOver, gameWon;
+        GameStats stats;
+        vector<shared_ptr<const Tile>> tiles;
+        
+        int tilesPerRow() const { return (cols + TILE - 1) / TILE; }
+        uint8_t cell(int x, int y) const {
+            return tiles[(size_t)(x / TILE) * tilesPerRow() + y / TILE]->cells[(x % TILE) * TILE + y % TILE];
+        }
+    };
+    
+private:
+    struct alignas(64) ReaderSlot {
+        atomic<uint64_t> epoch;          // announced epoch + 1, 0 while idle
+        atomic<bool> taken;
+    };
+    
+    atomic<const Snapshot*> current;
+    atomic<uint64_t> epoch;
+    ReaderSlot slots[MAX_READERS];
+    vector<pair<uint64_t, const Snapshot*>> retired;   // writer only, by retire epoch
+    vector<uint64_t> tileVersion;        // writer only: version a tile was last copied for
+    uint64_t version;
+    
+    // Copy one tile of the live board
+    static shared_ptr<const Tile> copyTile(const BoardView& view, int tileRow, int tileCol) {
+        shared_ptr<Tile> tile = make_shared<Tile>();
+        memset(tile->cells, BORDER_BIT | REVEALED_BIT, sizeof(tile->cells));
+        int rowEnd = min(view.rows, (tileRow + 1) * TILE), colEnd = min(view.cols, (tileCol + 1) * TILE);
+        for (int x = tileRow * TILE; x < rowEnd; x++) {
+            memcpy(&tile->cells[(x % TILE) * TILE], &view.cells[view.index(x, tileCol * TILE)], colEnd - tileCol * TILE);
+        }
+        return tile;
+    }
+    
+    // Swap in the next snapshot and free what no reader can still see
+    void install(Snapshot* next) {
+        const Snapshot* old = current.exchange(next);
+        uint64_t retiredAt = epoch.fetch_add(1) + 1;
+        if (old) retired.push_back(make_pair(retiredAt, old));
+        
+        uint64_t oldest = UINT64_MAX;
+        for (ReaderSlot& slot : slots) {
+            uint64_t announced = slot.epoch.load();
+            if (announced != 0) oldest = min(oldest, announced - 1);
+        }
+        size_t kept = 0;
+        for (size_t i = 0; i < retired.size(); i++) {
+            if (retired[i].first <= oldest) delete retired[i].second;
+            else retired[kept++] = retired[i];
+        }
+        retired.resize(kept);
+    }
+    
+    template <typename Game>
+    Snapshot* header(const Game& game) {
+        Snapshot* next = new Snapshot();
+        next->version = version++;
+        next->rows = game.getRows();
+        next->cols = game.getCols();
+        next->mines = game.getTotalMines();
+        next->seed = game.getSeed();
+        next->gameOver = game.isGameOver();
+        next->gameWon = game.isGameWon();
+        next->stats = game.getStats();
+        return next;
+    }
+    
+public:
+    // RAII read access; the snapshot stays valid while the Reader lives.
+    // get() is null when nothing was published or all reader slots are busy;
+    // busy() tells the two apart.
+    class Reader {
+    private:
+        ReaderSlot* slot;
+        const Snapshot* snapshot;
+        
+    public:
+        explicit Reader(SnapshotPublisher& publisher) : slot(nullptr), snapshot(nullptr) {
+            for (ReaderSlot& candidate : publisher.slots) {
+                bool expected = false;
+                if (!candidate.taken.load(memory_order_relaxed)
+                    && candidate.taken.compare_exchange_strong(expected, true, memory_order_acquire)) {
+                    slot = &candidate;
+                    break;
+                }
+            }
+            if (!slot) return;
+            slot->epoch.store(publisher.epoch.load() + 1);
+            snapshot = publisher.current.load();
+        }
+        ~Reader() {
+            if (!slot) return;
+            slot->epoch.store(0);
+            slot->taken.store(false, memory_order_release);
+        }
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        
+        const Snapshot* get() const { return snapshot; }
+        const Snapshot* operator->() const { return snapshot; }
+        bool busy() const { return !slot; }
+    };
+    
+    SnapshotPublisher() : current(nullptr), epoch(0), version(0) {
+        for (ReaderSlot& slot : slots) {
+            slot.epoch = 0;
+            slot.taken = false;
+        }
+    }
+    
+    // Readers must be gone by now
+    ~SnapshotPublisher() {
+        delete current.load();
+        for (auto& entry : retired) delete entry.second;
+    }
+    
+    // Publish every tile (a new game or new dimensions)
+    template <typename Game>
+    void publishAll(const Game& game) {
+        BoardView view = game.view();
+        Snapshot* next = header(game);
+        int tileRows = (view.rows + TILE - 1) / TILE;
+        int tileCols = (view.cols + TILE - 1) / TILE;
+        next->tiles.reserve((size_t)tileRows * tileCols);
+        for (int tr = 0; tr < tileRows; tr++) {
+            for (int tc = 0; tc < tileCols; tc++) next->tiles.push_back(copyTile(view, tr, tc));
+        }
+        tileVersion.assign(next->tiles.size(), next->version);
+        install(next);
+    }
+    
+    // Publish after a move that changed the given board indices
+    template <typename Game>
+    void publish(const Game& game, const vector<int>& changed) {
+        const Snapshot* previous = current.load(memory_order_relaxed);
+        if (!previous || previous->rows != game.getRows() || previous->cols != game.getCols()) {
+            publishAll(game);
+            return;
+        }
+        BoardView view = game.view();
+        Snapshot* next = header(game);
+        next->tiles = previous->tiles;
+        int perRow = next->tilesPerRow();
+        for (int idx : changed) {
+            int x = idx / view.stride - 1, y = idx % view.stride - 1;
+            size_t t = (size_t)(x / TILE) * perRow + y / TILE;
+            if (tileVersion[t] == next->version) continue;
+            tileVersion[t] = next->version;
+            next->tiles[t] = copyTile(view, x / TILE, y / TILE);
+        }
+        install(next);
+    }
+};
+
+// DSA: Compile-time board for the standard presets. Rows and Cols are
+// template constants, so the padded cells and all scratch space live in
+// std::arrays inside the object, the neighbor offsets are a constexpr
+// table and every index computation folds into constants. Only the
+// headless move path is specialized - no rendering, saves, undo or
+// no-guess generation. Flood fill, chording and the safe-start relocation
+// are the same kernels Minesweeper calls (floodReveal, chordReveal,
+// clearStartZone), so the same seed gives the same board and the same move
+// results; --verify checks both against ReferenceBoard.
+template <int Rows, int Cols>
+class PresetGame {
+public:
+    static constexpr int STRIDE = Cols + 2;
+    static constexpr int CELLS = Rows * Cols;
+    static constexpr array<int, 8> NEIGHBOR_OFFSET = {
+        -STRIDE - 1, -STRIDE, -STRIDE + 1, -1, 1, STRIDE - 1, STRIDE, STRIDE + 1};
+    
+private:
+    array<uint8_t, (Rows + 2) * STRIDE> cells;
+    array<int, CELLS> mineCells;     // board indices of every mine
+    FixedStack<CELLS> fillStack;     // span seeds; each is revealed when pushed
+    vector<int> lastChanged;         // reserved to CELLS up front
+    int totalMines;
+    uint64_t seed;
+    Xoshiro256 rng;
+    StartMode startMode;             // START_NO_GUESS is treated as START_SAFE
+    bool generated, gameOver, gameWon;
+    GameStats stats;
+    
+    void markRevealed(int idx) {
+        cells[idx] |= REVEALED_BIT;
+        lastChanged.push_back(idx);
+        stats.cellsRevealed++;
+        if (!(cells[idx] & MINE_BIT)) stats.safeRevealed++;
+    }
+    
+    // Same draw sequence as placeMinesFloyd, with constant divisors
+    void placeMines() {
+        for (int j = CELLS - totalMines, m = 0; j < CELLS; j++, m++) {
+            int k = (int)rng.nextBelow((uint32_t)j + 1);
+            int idx = index(k / Cols, k % Cols);
+            if (cells[idx] & MINE_BIT) {
+                idx = index(j / Cols, j % Cols);
+            }
+            cells[idx] |= MINE_BIT;
+            mineCells[m] = idx;
+        }
+        for (int m = 0; m < totalMines; m++) {
+            for (int offset : NEIGHBOR_OFFSET) cells[mineCells[m] + offset]++;
+        }
+        generated = true;
+    }
+    
+    // Minesweeper::generateAround with the same rng draws
+    void generateAround(int clicked) {
+        placeMines();
+        clearStartZone(cells.data(), Rows, Cols, NEIGHBOR_OFFSET.data(), clicked, mineCells.data(), totalMines, rng);
+        if (stats.flagsPlaced > 0) {
+            stats.correctFlags += countFlaggedMines(cells.data(), mineCells.data(), totalMines);
+        }
+    }
+    
+    void reveal(int idx) {
+        if (!generated && !(cells[idx] & FLAGGED_BIT)) generateAround(idx);
+        if (floodReveal(cells.data(), STRIDE, idx, fillStack, [this](int cell) { markRevealed(cell); })) {
+            gameOver = true;
+        }
+    }
+    
+    void chord(int idx) {
+        if (chordReveal(cells.data(), STRIDE, NEIGHBOR_OFFSET.data(), idx, fillStack,
+                        [this](int cell) { markRevealed(cell); })) {
+            gameOver = true;
+        }
+    }
+    
+    void flipFlag(int idx) {
+        if (cells[idx] & REVEALED_BIT) return;
+        lastChanged.push_back(idx);
+        cells[idx] ^= FLAGGED_BIT;
+        int delta = (cells[idx] & FLAGGED_BIT) ? 1 : -1;
+        stats.flagsPlaced += delta;
+        if (cells[idx] & MINE_BIT) stats.correctFlags += delta;
+    }
+    
+public:
+    PresetGame(int mines, uint64_t boardSeed, StartMode start = START_ANYWHERE)
+        : totalMines(mines), seed(boardSeed), rng(boardSeed), startMode(start) {
+        lastChanged.reserve(CELLS);
+        reset(boardSeed);
+    }
+    
+    // Start over with a new layout; rebuilding the border ring also clears
+    // the counts the mine scatter left on it
+    void reset(uint64_t boardSeed) {
+        initBoardCells(cells.data(), Rows, Cols);
+        lastChanged.clear();
+        seed = boardSeed;
+        rng.reseed(boardSeed);
+        generated = gameOver = gameWon = false;
+        stats = GameStats{0, 0, 0, 0, CELLS - totalMines};
+        if (startMode == START_ANYWHERE) placeMines();
+    }
+    
+    static constexpr bool isValid(int x, int y) {
+        return (unsigned)x < (unsigned)Rows && (unsigned)y < (unsigned)Cols;
+    }
+    static constexpr int index(int x, int y) { return (x + 1) * STRIDE + (y + 1); }
+    static constexpr int rowOf(int idx) { return idx / STRIDE - 1; }
+    static constexpr int colOf(int idx) { return idx % STRIDE - 1; }
+    
+    // Same contract as Minesweeper::applyMove
+    MoveResult applyMove(const Move& move) {
+        lastChanged.clear();
+        MoveStatus status;
+        if (gameOver || gameWon) {
+            status = MOVE_GAME_ENDED;
+        } else if ((move.type != 'r' && move.type != 'f' && move.type != 'c') || !isValid(move.x, move.y)) {
+            status = MOVE_INVALID;
+        } else {
+            int idx = index(move.x, move.y);
+            if (move.type == 'r') reveal(idx);
+            else if (move.type == 'c') chord(idx);
+            else flipFlag(idx);
+            status = lastChanged.empty() ? MOVE_NO_CHANGE : MOVE_APPLIED;
+            if (stats.safeRevealed == stats.safeCells) gameWon = true;
+        }
+        return MoveResult{status, gameOver, gameWon, &lastChanged};
+    }
+    
+    bool isGameOver() const { return gameOver; }
+    bool isGameWon() const { return gameWon; }
+    uint64_t getSeed() const { return seed; }
+    const GameStats& getStats() const { return stats; }
+    BoardView view() const { return BoardView{Rows, Cols, STRIDE, cells.data()}; }
+};
+
+// Run f on a PresetGame when rows x cols is one of the difficulty presets
+// and the start mode needs no solver; false means use Minesweeper instead
+template <typename F>
+bool withPresetGame(int rows, int cols, int mines, uint64_t seed, StartMode start, F&& f) {
+    if (start == START_NO_GUESS) return false;
+    if (rows == 9 && cols == 9) {
+        PresetGame<9, 9> game(mines, seed, start);
+        f(game);
+    } else if (rows == 16 && cols == 16) {
+        PresetGame<16, 16> game(mines, seed, start);
+        f(game);
+    } else if (rows == 16 && cols == 30) {
+        PresetGame<16, 30> game(mines, seed, start);
+        f(game);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// DSA: Block-buffered move stream - text "r x y" / "f x y" / "c x y" lines
+// (plus "n [seed]" to start the next game and "q" to stop), or fixed 9-byte
+// binary records: command byte, then x and y as little-endian int32
+// (an 'n' record carries its seed in x/y as low/high halves, 0 = next)
+class MoveStreamReader {
+private:
+    FILE* file;
+    bool binary;
+    vector<char> buffer;
+    size_t begin, end;           // unread bytes are buffer[begin, end)
+    bool eof;
+    
+    // Make at least `need` unread bytes available unless the input ends
+    bool fill(size_t need) {
+        while (end - begin < need && !eof) {
+            if (begin > 0) {
+                memmove(buffer.data(), buffer.data() + begin, end - begin);
+                end -= begin;
+                begin = 0;
+            }
+            size_t got = fread(buffer.data() + end, 1, buffer.size() - end, file);
+            if (got == 0) eof = true;
+            end += got;
+        }
+        return end - begin >= need;
+    }
+    
+    static int32_t readInt32(const char* p) {
+        uint32_t value = (uint32_t)(uint8_t)p[0] | (uint32_t)(uint8_t)p[1] << 8
+                       | (uint32_t)(uint8_t)p[2] << 16 | (uint32_t)(uint8_t)p[3] << 24;
+        return (int32_t)value;
+    }
+    
+public:
+    MoveStreamReader(FILE* input, bool binaryRecords)
+        : file(input), binary(binaryRecords), buffer(1 << 20), begin(0), end(0), eof(false) {}
+    
+    // Next command: fills type and arguments (argc = number parsed).
+    // Returns false at end of input; malformed lines come back as type '?'
+    bool next(char& type, long long args[2], int& argc) {
+        if (binary) {
+            if (!fill(9)) return false;
+            const char* p = buffer.data() + begin;
+            type = p[0];
+            args[0] = readInt32(p + 1);
+            args[1] = readInt32(p + 5);
+            argc = 2;
+            begin += 9;
+            if (type == 'n') {
+                // New game record: seed split over x (low) and y (high), 0 = next
+                uint64_t nextSeed = (uint32_t)args[0] | (uint64_t)(uint32_t)args[1] << 32;
+                args[0] = (long long)nextSeed;
+                argc = nextSeed != 0 ? 1 : 0;
+            }
+            return true;
+        }
+        
+        while (true) {
+            // Find a complete line, growing the buffer for very long ones
+            const char* start = buffer.data() + begin;
+            const char* newline = (const char*)memchr(start, '\n', end - begin);
+            while (!newline && !eof) {
+                if (begin == 0 && end == buffer.size()) buffer.resize(buffer.size() * 2);
+                fill(end - begin + 1);
+                start = buffer.data() + begin;
+                newline = (const char*)memchr(start, '\n', end - begin);
+            }
+            if (!newline && begin == end) return false;
+            const char* last = newline ? newline : buffer.data() + end;
+            begin = (size_t)(last - buffer.data()) + (newline ? 1 : 0);
+            
+            if (parseCommand(start, last, type, args, argc)) return true;
+        }
+    }
+};
+
+// DSA: Append-only game log (version 1): "MSGL" and a version byte, then
+// one record per game, each a varint body length followed by the body:
+//   varint rows, cols, mines, start mode; seed u64 little-endian;
+//   one varint per applied move: (x * cols + y) << 2 | kind (0 r, 1 f, 2 c)
+// Boards are rebuilt from the configuration and the seed, so a move costs
+// one or two bytes. Records are appended whole, so games played at the same
+// time never interleave, and a torn tail only loses the last record.
+const uint8_t GAME_LOG_VERSION = 1;
+const size_t GAME_LOG_MAX_RECORD = 1 << 26;
+
+// One game being recorded
+class GameRecord {
+private:
+    int cols;
+    vector<uint8_t> body;
+    size_t moves;
+    
+public:
+    GameRecord() : cols(0), moves(0) {}
+    
+    void begin(int rows, int boardCols, int mines, StartMode start, uint64_t seed) {
+        cols = boardCols;
+        moves = 0;
+        body.clear();
+        putVarint(body, (uint64_t)rows);
+        putVarint(body, (uint64_t)cols);
+        putVarint(body, (uint64_t)mines);
+        putVarint(body, (uint64_t)start);
+        body.resize(body.size() + 8);
+        putLE(&body[body.size() - 8], seed, 8);
+    }
+    
+    // Only applied moves are kept: the others change nothing on replay
+    void add(const Move& move) {
+        uint64_t kind = move.type == 'r' ? 0 : move.type == 'f' ? 1 : 2;
+        putVarint(body, ((uint64_t)move.x * cols + move.y) << 2 | kind);
+        moves++;
+    }
+    
+    size_t moveCount() const { return moves; }
+    const vector<uint8_t>& bytes() const { return body; }
+};
+
+// Thread-safe log appender. Records collect in one fixed-size buffer that
+// is written out whenever the next record would not fit, so memory stays
+// bounded however many games are logged.
+class GameLogWriter {
+private:
+    FILE* file;
+    vector<uint8_t> buffer;
+    size_t used;
+    vector<uint8_t> prefix;
+    long long games;
+    bool failed;                     // a write failed; nothing is written after it
+    mutex lock;
+    
+    void writeLocked(const uint8_t* data, size_t size) {
+        if (!failed && fwrite(data, 1, size, file) != size) failed = true;
+    }
+    
+    void flushLocked() {
+        if (used > 0) writeLocked(buffer.data(), used);
+        used = 0;
+    }
+    
+public:
+    explicit GameLogWriter(size_t capacity = 1 << 16)
+        : file(nullptr), buffer(capacity), used(0), games(0), failed(false) {}
+    ~GameLogWriter() { close(); }
+    
+    // Append to path, writing the file header if the log is new
+    bool open(const string& path) {
+        file = fopen(path.c_str(), "ab");
+        if (!file) return false;
+        fseek(file, 0, SEEK_END);
+        if (ftell(file) == 0) {
+            const uint8_t header[5] = {'M', 'S', 'G', 'L', GAME_LOG_VERSION};
+            writeLocked(header, sizeof(header));
+        }
+        return !failed;
+    }
+    
+    void append(const GameRecord& record) {
+        const vector<uint8_t>& body = record.bytes();
+        lock_guard<mutex> guard(lock);
+        prefix.clear();
+        putVarint(prefix, body.size());
+        size_t need = prefix.size() + body.size();
+        if (used + need > buffer.size()) flushLocked();
+        if (need > buffer.size()) {
+            writeLocked(prefix.data(), prefix.size());
+            writeLocked(body.data(), body.size());
+        } else {
+            memcpy(&buffer[used], prefix.data(), prefix.size());
+            memcpy(&buffer[used + prefix.size()], body.data(), body.size());
+            used += need;
+        }
+        games++;
+    }
+    
+    // Flush and close; false if any write since open() failed
+    bool close() {
+        if (!file) return !failed;
+        flushLocked();
+        if (fclose(file) != 0) failed = true;
+        file = nullptr;
+        return !failed;
+    }
+    
+    long long gamesWritten() const { return games; }
+};
+
+// Streaming log reader: records are decoded in place from a block buffer,
+// so a log of any length is replayed in constant memory
+class GameLogReader {
+public:
+    struct Header {
+        int rows, cols, mines;
+        StartMode start;
+        uint64_t seed;
+    };
+    
+private:
+    FILE* file;
+    vector<uint8_t> buffer;
+    size_t begin, end;             // unread bytes are buffer[begin, end)
+    bool eof;
+    const uint8_t* cursor;         // unread moves of the current record
+    const uint8_t* recordEnd;
+    int rows, cols;
+    long long consumed;
+    string problem;
+    
+    // Make at least `need` unread bytes available unless the input ends
+    bool fill(size_t need) {
+        if (need > buffer.size()) buffer.resize(need);
+        while (end - begin < need && !eof) {
+            if (begin > 0) {
+                memmove(buffer.data(), buffer.data() + begin, end - begin);
+                end -= begin;
+                begin = 0;
+            }
+            size_t got = fread(buffer.data() + end, 1, buffer.size() - end, file);
+            if (got == 0) eof = true;
+            end += got;
+        }
+        return end - begin >= need;
+    }
+    
+    bool fail(const char* what) {
+        problem = what;
+        cursor = recordEnd = nullptr;
+        return false;
+    }
+    
+public:
+    explicit GameLogReader(FILE* input)
+        : file(input), buffer(1 << 20), begin(0), end(0), eof(false),
+          cursor(nullptr), recordEnd(nullptr), rows(0), cols(0), consumed(0) {}
+    
+    bool readHeader() {
+        if (!fill(5) || memcmp(buffer.data() + begin, "MSGL", 4) != 0) return fail("not a game log");
+        if (buffer[begin + 4] != GAME_LOG_VERSION) return fail("unsupported version");
+        begin += 5;
+        consumed += 5;
+        return true;
+    }
+    
+    // Start the next record, skipping any unread moves of the last one.
+    // False at the end of the log, or on a damaged record (see error()).
+    bool nextGame(Header& header) {
+        cursor = recordEnd = nullptr;
+        if (!fill(1)) return false;
+        fill(10);
+        const uint8_t* p = buffer.data() + begin;
+        uint64_t length;
+        if (!getVarint(p, buffer.data() + end, length)) return fail("truncated record");
+        if (length > GAME_LOG_MAX_RECORD) return fail("corrupt record");
+        size_t prefixBytes = (size_t)(p - (buffer.data() + begin));
+        if (!fill(prefixBytes + (size_t)length)) return fail("truncated record");
+        
+        p = buffer.data() + begin + prefixBytes;
+        const uint8_t* last = p + length;
+        begin += prefixBytes + (size_t)length;
+        consumed += (long long)(prefixBytes + length);
+        
+        uint64_t fields[4];
+        for (uint64_t& field : fields) {
+            if (!getVarint(p, last, field)) return fail("corrupt record");
+        }
+        if (last - p < 8 || fields[3] > START_NO_GUESS || fields[0] > INT_MAX || fields[1] > INT_MAX
+            || fields[2] > INT_MAX || !validSettings((int)fields[0], (int)fields[1], (int)fields[2])) {
+            return fail("corrupt record");
+        }
+        header = Header{(int)fields[0], (int)fields[1], (int)fields[2], (StartMode)fields[3], getLE(p, 8)};
+        rows = header.rows;
+        cols = header.cols;
+        cursor = p + 8;
+        recordEnd = last;
+        return true;
+    }
+    
+    // Next move of the current record; false when it has no more (or on a
+    // damaged move, see error())
+    bool nextMove(Move& move) {
+        if (cursor == recordEnd) return false;
+        uint64_t code;
+        if (!getVarint(cursor, recordEnd, code) || (code & 3) == 3 || (code >> 2) >= (uint64_t)rows * cols) {
+            return fail("corrupt move");
+        }
+        int cell = (int)(code >> 2);
+        move = Move{"rfc"[code & 3], cell / cols, cell % cols};
+        return true;
+    }
+    
+    const string& error() const { return problem; }
+    long long bytesRead() const { return consumed; }
+};
+
+// Elapsed wall-clock seconds since `start`
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Batch totals; counts are indexed by MoveStatus
+struct BatchTotals {
+    long long counts[4] = {0, 0, 0, 0};
+    long long games = 1, wins = 0, losses = 0, malformed = 0;
+};
+
+// Feed a move stream to one game object (Minesweeper or a PresetGame)
+template <typename Game>
+void replayStream(MoveStreamReader& reader, Game& game, uint64_t seed, BatchTotals& totals) {
+    char type;
+    long long args[2];
+    int argc;
+    while (reader.next(type, args, argc)) {
+        if (type == 'q' && argc == 0) {
+            break;
+        }
+        if (type == 'n' && argc <= 1) {
+            if (game.isGameWon()) totals.wins++;
+            else if (game.isGameOver()) totals.losses++;
+            game.reset(argc == 1 ? (uint64_t)args[0] : seed + totals.games);
+            totals.games++;
+            continue;
+        }
+        if ((type != 'r' && type != 'f' && type != 'c') || argc != 2
+            || args[0] < INT32_MIN || args[0] > INT32_MAX || args[1] < INT32_MIN || args[1] > INT32_MAX) {
+            totals.malformed++;
+            continue;
+        }
+        totals.counts[game.applyMove(Move{type, (int)args[0], (int)args[1]}).status]++;
+    }
+    if (game.isGameWon()) totals.wins++;
+    else if (game.isGameOver()) totals.losses++;
+}
+
+// Replay a move stream against headless games at full speed, no rendering.
+// Preset sizes are replayed on the compile-time PresetGame
+int runBatch(const string& path, bool binary, int rows, int cols, int mines, uint64_t seed, StartMode start) {
+    FILE* input = path == "-" ? stdin : fopen(path.c_str(), binary ? "rb" : "r");
+    if (!input) {
+        cerr << "Cannot open move stream: " << path << "\n";
+        return 1;
+    }
+    
+    MoveStreamReader reader(input, binary);
+    BatchTotals totals;
+    auto started = chrono::steady_clock::now();
+    
+    bool preset = withPresetGame(rows, cols, mines, seed, start, [&](auto& game) {
+        replayStream(reader, game, seed, totals);
+    });
+    if (!preset) {
+        unique_ptr<Minesweeper> game(new Minesweeper(rows, cols, mines, seed, start));
+        replayStream(reader, *game, seed, totals);
+    }
+    if (input != stdin) fclose(input);
+    
+    const long long* counts = totals.counts;
+    double seconds = secondsSince(started);
+    long long moves = counts[MOVE_APPLIED] + counts[MOVE_NO_CHANGE] + counts[MOVE_INVALID] + counts[MOVE_GAME_ENDED];
+    cout << "games=" << totals.games << " wins=" << totals.wins << " losses=" << totals.losses
+         << " moves=" << moves << " applied=" << counts[MOVE_APPLIED] << " no_change=" << counts[MOVE_NO_CHANGE]
+         << " invalid=" << counts[MOVE_INVALID] << " after_end=" << counts[MOVE_GAME_ENDED]
+         << " malformed=" << totals.malformed << " seconds=" << seconds
+         << " moves_per_sec=" << (seconds > 0 ? (long long)(moves / seconds) : 0) << "\n";
+    return 0;
+}
+
+// Replay a game log through pooled headless games and total the outcomes.
+// Every logged move was applied when it was recorded, so a move that no
+// longer applies means the log and this engine disagree (diverged).
+int runReplayLog(const string& path) {
+    FILE* input = path == "-" ? stdin : fopen(path.c_str(), "rb");
+    if (!input) {
+        cerr << "Cannot open game log: " << path << "\n";
+        return 1;
+    }
+    
+    GameLogReader reader(input);
+    GamePool pool;
+    GameLogReader::Header header;
+    Move logged;
+    long long games = 0, wins = 0, losses = 0, moves = 0, diverged = 0;
+    auto started = chrono::steady_clock::now();
+    if (reader.readHeader()) {
+        while (reader.nextGame(header)) {
+            unique_ptr<Minesweeper> game = pool.acquire(header.rows, header.cols, header.mines, header.seed, header.start);
+            long long gameMoves = 0, gameDiverged = 0;
+            while (reader.nextMove(logged)) {
+                gameMoves++;
+                gameDiverged += game->applyMove(logged).status != MOVE_APPLIED;
+            }
+            if (!reader.error().empty()) break;   // a damaged record is not a game
+            games++;
+            moves += gameMoves;
+            diverged += gameDiverged;
+            wins += game->isGameWon();
+            losses += game->isGameOver();
+            pool.release(move(game));
+        }
+    }
+    if (input != stdin) fclose(input);
+    
+    double seconds = secondsSince(started);
+    cout << "games=" << games << " wins=" << wins << " losses=" << losses
+         << " unfinished=" << games - wins - losses << " moves=" << moves << " diverged=" << diverged
+         << " bytes=" << reader.bytesRead() << " seconds=" << seconds
+         << " games_per_sec=" << (seconds > 0 ? (long long)(games / seconds) : 0) << "\n";
+    if (!reader.error().empty()) {
+        cerr << "Game log " << path << ": " << reader.error() << " after " << games << " games\n";
+        return 1;
+    }
+    return 0;
+}
+
+// Bitboard backend on the same boards: generation, flood fill from the
+// first opening plus a full-board popcount win check
+template <typename Report>
+void benchBitBoard(int rows, int cols, int mines, uint64_t seed, double minSeconds, Report& report) {
+    BitBoard board(rows, cols, mines);
+    double cellCount = (double)rows * cols;
+    
+    long long boards = 0;
+    auto started = chrono::steady_clock::now();
+    while (boards < 3 || secondsSince(started) < minSeconds) {
+        for (int i = 0; i < 64; i++, boards++) board.generate(seed + boards);
+    }
+    double seconds = secondsSince(started);
+    report("bitboard.generate", boards, seconds,
+           ",\"ns_per_cell\":" + to_string(seconds * 1e9 / (boards * cellCount))
+           + ",\"boards_per_sec\":" + to_string(boards / seconds));
+    
+    double fillSeconds = 0;
+    long long fills = 0, revealedCells = 0, wins = 0;
+    started = chrono::steady_clock::now();
+    for (long long b = 0; fills < 3 || secondsSince(started) < minSeconds; b++) {
+        board.generate(seed + b);
+        int x = -1, y = -1;
+        for (int i = 0; i < rows && x < 0; i++) {
+            for (int j = 0; j < cols; j++) {
+                if (!board.isMine(i, j) && board.adjacentMines(i, j) == 0) {
+                    x = i; y = j;
+                    break;
+                }
+            }
+        }
+        if (x < 0) {
+            if (b > 1000) break;
+            continue;
+        }
+        auto t0 = chrono::steady_clock::now();
+        revealedCells += board.revealCell(x, y);
+        wins += board.checkWin();
+        fillSeconds += secondsSince(t0);
+        fills++;
+    }
+    if (fills > 0) {
+        report("bitboard.revealCell", fills, fillSeconds,
+               ",\"cells_revealed\":" + to_string(revealedCells)
+               + ",\"ns_per_cell\":" + to_string(fillSeconds * 1e9 / max(1LL, revealedCells))
+               + ",\"reveals_per_sec\":" + to_string(revealedCells / fillSeconds));
+    }
+}
+
+// Whole games of random moves (mostly reveals, some flags and chords)
+// until each ends; the same move sequence for Minesweeper and PresetGame
+template <typename Game, typename Report>
+void benchPlay(const char* name, Game& game, int rows, int cols, uint64_t seed, double minSeconds, Report& report) {
+    Xoshiro256 moves(seed);
+    long long games = 0, applied = 0;
+    auto started = chrono::steady_clock::now();
+    while (games < 3 || secondsSince(started) < minSeconds) {
+        for (int i = 0; i < 64; i++, games++) {
+            game.reset(seed + games);
+            while (!game.isGameOver() && !game.isGameWon()) {
+                uint32_t roll = moves.nextBelow(8);
+                char type = roll < 6 ? 'r' : roll == 6 ? 'f' : 'c';
+                Move move{type, (int)moves.nextBelow((uint32_t)rows), (int)moves.nextBelow((uint32_t)cols)};
+                applied += game.applyMove(move).status == MOVE_APPLIED;
+            }
+        }
+    }
+    double seconds = secondsSince(started);
+    report(name, games, seconds,
+           ",\"games_per_sec\":" + to_string(games / seconds)
+           + ",\"applied_moves_per_sec\":" + to_string(applied / seconds));
+}
+
+// Benchmark harness: times board generation, flood fill and win checks on
+// the presets and large custom boards with fixed seeds, one JSON object per
+// line. Each measurement repeats until it has run for at least minSeconds.
+int runBenchmarks(uint64_t seed, double minSeconds) {
+    struct Config { const char* name; int rows, cols, mines; };
+    const Config configs[] = {
+        {"beginner", 9, 9, 10},
+        {"intermediate", 16, 16, 40},
+        {"expert", 16, 30, 99},
+        {"custom-1k-1pct", 1000, 1000, 10000},
+        {"custom-1k-5pct", 1000, 1000, 50000},
+        {"custom-1k-15pct", 1000, 1000, 150000},
+        {"custom-1k-30pct", 1000, 1000, 300000},
+        {"custom-4k-1pct", 4000, 4000, 160000},
+    };
+    
+    for (const Config& config : configs) {
+        Minesweeper game(config.rows, config.cols, config.mines, seed);
+        double cellCount = (double)config.rows * config.cols;
+        auto report = [&](const char* bench, long long iterations, double seconds, const string& extra) {
+            cout << "{\"bench\":\"" << bench << "\",\"config\":\"" << config.name
+                 << "\",\"rows\":" << config.rows << ",\"cols\":" << config.cols
+                 << ",\"mines\":" << config.mines << ",\"seed\":" << seed
+                 << ",\"iterations\":" << iterations << ",\"seconds\":" << seconds << extra << "}\n";
+        };
+        
+        // placeMines and calculateNumbers, timed separately per board
+        double placeSeconds = 0, numberSeconds = 0;
+        long long boards = 0;
+        auto started = chrono::steady_clock::now();
+        while (boards < 3 || secondsSince(started) < minSeconds) {
+            game.clearBoard(seed + boards);
+            auto t0 = chrono::steady_clock::now();
+            game.placeMines();
+            auto t1 = chrono::steady_clock::now();
+            game.calculateNumbers();
+            numberSeconds += secondsSince(t1);
+            placeSeconds += chrono::duration<double>(t1 - t0).count();
+            boards++;
+        }
+        report("placeMines", boards, placeSeconds,
+               ",\"ns_per_cell\":" + to_string(placeSeconds * 1e9 / (boards * cellCount))
+               + ",\"boards_per_sec\":" + to_string(boards / placeSeconds));
+        report("calculateNumbers", boards, numberSeconds,
+               ",\"ns_per_cell\":" + to_string(numberSeconds * 1e9 / (boards * cellCount))
+               + ",\"boards_per_sec\":" + to_string(boards / numberSeconds));
+        
+        // revealCell from the first zero cell of each board
+        double fillSeconds = 0;
+        long long fills = 0, revealedCells = 0;
+        started = chrono::steady_clock::now();
+        for (long long board = 0; fills < 3 || secondsSince(started) < minSeconds; board++) {
+            game.generate(seed + board);
+            int x = -1, y = -1;
+            for (int i = 0; i < config.rows && x < 0; i++) {
+                for (int j = 0; j < config.cols; j++) {
+                    if (!game.isMine(i, j) && game.adjacentMines(i, j) == 0) {
+                        x = i; y = j;
+                        break;
+                    }
+                }
+            }
+            if (x < 0) {
+                if (board > 1000) break;   // density too high for any opening
+                continue;
+            }
+            auto t0 = chrono::steady_clock::now();
+            revealedCells += (long long)game.revealCell(x, y).size();
+            fillSeconds += secondsSince(t0);
+            fills++;
+        }
+        if (fills > 0) {
+            report("revealCell", fills, fillSeconds,
+                   ",\"cells_revealed\":" + to_string(revealedCells)
+                   + ",\"ns_per_cell\":" + to_string(fillSeconds * 1e9 / max(1LL, revealedCells))
+                   + ",\"reveals_per_sec\":" + to_string(revealedCells / fillSeconds));
+        }
+        
+        // checkWin after the last fill
+        long long checks = 0, won = 0;
+        started = chrono::steady_clock::now();
+        while (checks < 1000 || secondsSince(started) < minSeconds) {
+            for (int i = 0; i < 1000; i++) won += game.checkWin();
+            checks += 1000;
+        }
+        double checkSeconds = secondsSince(started);
+        report("checkWin", checks, checkSeconds,
+               ",\"ns_per_call\":" + to_string(checkSeconds * 1e9 / checks)
+               + ",\"won\":" + to_string(won > 0));
+        
+        // New game cost: fresh construction vs reset() on existing storage
+        long long created = 0;
+        started = chrono::steady_clock::now();
+        while (created < 3 || secondsSince(started) < minSeconds) {
+            Minesweeper fresh(config.rows, config.cols, config.mines, seed + created);
+            created++;
+        }
+        double constructSeconds = secondsSince(started);
+        long long resets = 0;
+        started = chrono::steady_clock::now();
+        while (resets < 3 || secondsSince(started) < minSeconds) {
+            game.reset(seed + resets);
+            resets++;
+        }
+        double resetSeconds = secondsSince(started);
+        report("construct", created, constructSeconds,
+               ",\"games_per_sec\":" + to_string(created / constructSeconds));
+        report("reset", resets, resetSeconds,
+               ",\"games_per_sec\":" + to_string(resets / resetSeconds));
+        
+        // Save format round trip in memory (plain bit planes)
+        vector<uint8_t> image;
+        Minesweeper restored(1, 1, 0, seed);
+        string error;
+        long long saves = 0;
+        double saveSeconds = 0, loadSeconds = 0;
+        started = chrono::steady_clock::now();
+        while (saves < 3 || secondsSince(started) < minSeconds) {
+            auto t0 = chrono::steady_clock::now();
+            game.serialize(image, false);
+            auto t1 = chrono::steady_clock::now();
+            restored.deserialize(image.data(), image.size(), error);
+            loadSeconds += secondsSince(t1);
+            saveSeconds += chrono::duration<double>(t1 - t0).count();
+            saves++;
+        }
+        report("save", saves, saveSeconds,
+               ",\"bytes\":" + to_string(image.size())
+               + ",\"us_per_save\":" + to_string(saveSeconds * 1e6 / saves));
+        report("load", saves, loadSeconds,
+               ",\"us_per_load\":" + to_string(loadSeconds * 1e6 / saves));
+        
+        // Headless play, and the same games on the compile-time preset board
+        withPresetGame(config.rows, config.cols, config.mines, seed, START_ANYWHERE, [&](auto& preset) {
+            benchPlay("play", game, config.rows, config.cols, seed, minSeconds, report);
+            benchPlay("preset.play", preset, config.rows, config.cols, seed, minSeconds, report);
+        });
+        
+        if (BitBoard::fits(config.rows, config.cols)) {
+            benchBitBoard(config.rows, config.cols, config.mines, seed, minSeconds, report);
+        }
+    }
+    return 0;
+}
+
+// DSA: Reference board for --verify: the plain algorithms on a 2D grid, with
+// no padding, bit packing or worklists. Mines take the same Floyd draws as
+// placeMinesFloyd, counts look at the 8 neighbors of each cell, reveals
+// flood breadth-first and the win check scans every cell. The fast paths
+// are checked against it, so it is written to be obviously right, not quick.
+class ReferenceBoard {
+private:
+    int rows, cols, totalMines;
+    vector<vector<uint8_t>> mine, revealed, flagged, count;
+    bool lost;
+    
+    bool inside(int x, int y) const { return x >= 0 && x < rows && y >= 0 && y < cols; }
+    
+public:
+    ReferenceBoard(int r, int c, int mines) : rows(r), cols(c), totalMines(mines), lost(false) {}
+    
+    void placeMines(uint64_t seed) {
+        mine.assign(rows, vector<uint8_t>(cols, 0));
+        revealed = flagged = count = mine;
+        lost = false;
+        Xoshiro256 rng(seed);
+        int total = rows * cols;
+        for (int j = total - totalMines; j < total; j++) {
+            int k = (int)rng.nextBelow((uint32_t)j + 1);
+            if (mine[k / cols][k % cols]) k = j;
+            mine[k / cols][k % cols] = 1;
+        }
+    }
+    
+    void calculateNumbers() {
+        for (int x = 0; x < rows; x++) {
+            for (int y = 0; y < cols; y++) {
+                int adjacent = 0;
+                for (int dx = -1; dx <= 1; dx++) {
+                    for (int dy = -1; dy <= 1; dy++) {
+                        if ((dx != 0 || dy != 0) && inside(x + dx, y + dy)) adjacent += mine[x + dx][y + dy];
+                    }
+                }
+                count[x][y] = (uint8_t)adjacent;
+            }
+        }
+    }
+    
+    void reset(uint64_t seed) {
+        placeMines(seed);
+        calculateNumbers();
+    }
+    
+    void revealCell(int x, int y) {
+        if (!inside(x, y) || revealed[x][y] || flagged[x][y]) return;
+        revealed[x][y] = 1;
+        if (mine[x][y]) {
+            lost = true;
+            return;
+        }
+        queue<pair<int, int>> open;
+        open.push(make_pair(x, y));
+        while (!open.empty()) {
+            pair<int, int> cell = open.front();
+            open.pop();
+            if (count[cell.first][cell.second] != 0) continue;
+            for (int dx = -1; dx <= 1; dx++) {
+                for (int dy = -1; dy <= 1; dy++) {
+                    int nx = cell.first + dx, ny = cell.second + dy;
+                    if (!inside(nx, ny) || revealed[nx][ny] || flagged[nx][ny]) continue;
+                    revealed[nx][ny] = 1;
+                    open.push(make_pair(nx, ny));
+                }
+            }
+        }
+    }
+    
+    // Reveal every neighbor of a revealed number whose flags match its count
+    void chordCell(int x, int y) {
+        if (!inside(x, y) || !revealed[x][y] || mine[x][y] || count[x][y] == 0) return;
+        int flags = 0;
+        for (int dx = -1; dx <= 1; dx++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                if ((dx != 0 || dy != 0) && inside(x + dx, y + dy)) flags += flagged[x + dx][y + dy];
+            }
+        }
+        if (flags != count[x][y]) return;
+        for (int dx = -1; dx <= 1; dx++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                if (dx != 0 || dy != 0) revealCell(x + dx, y + dy);
+            }
+        }
+    }
+    
+    void toggleFlag(int x, int y) {
+        if (inside(x, y) && !revealed[x][y]) flagged[x][y] ^= 1;
+    }
+    
+    bool checkWin() const {
+        int safeRevealed = 0;
+        for (int x = 0; x < rows; x++) {
+            for (int y = 0; y < cols; y++) safeRevealed += !mine[x][y] && revealed[x][y];
+        }
+        return safeRevealed == rows * cols - totalMines;
+    }
+    
+    void applyMove(const Move& move) {
+        if (lost || checkWin()) return;
+        if (move.type == 'r') revealCell(move.x, move.y);
+        else if (move.type == 'f') toggleFlag(move.x, move.y);
+        else if (move.type == 'c') chordCell(move.x, move.y);
+    }
+    
+    bool isGameOver() const { return lost; }
+    bool isGameWon() const { return checkWin(); }
+    bool isMine(int x, int y) const { return mine[x][y]; }
+    int adjacentMines(int x, int y) const { return count[x][y]; }
+    
+    // Cell (x, y) in the Minesweeper cell encoding
+    uint8_t cell(int x, int y) const {
+        return (uint8_t)(count[x][y] | (mine[x][y] ? MINE_BIT : 0) | (revealed[x][y] ? REVEALED_BIT : 0)
+                         | (flagged[x][y] ? FLAGGED_BIT : 0));
+    }
+};
+
+// True if cellAt(x, y) agrees with the reference on every mine, revealed and
+// flagged bit, and on the count of every safe cell
+template <typename CellAt>
+bool sameBoard(const ReferenceBoard& reference, int rows, int cols, CellAt cellAt) {
+    const uint8_t STATE = MINE_BIT | REVEALED_BIT | FLAGGED_BIT;
+    for (int x = 0; x < rows; x++) {
+        for (int y = 0; y < cols; y++) {
+            uint8_t expected = reference.cell(x, y), actual = cellAt(x, y);
+            if ((expected & STATE) != (actual & STATE)) return false;
+            if (!(expected & MINE_BIT) && (expected & COUNT_MASK) != (actual & COUNT_MASK)) return false;
+        }
+    }
+    return true;
+}
+
+// Random move for the play checks; without chords, 'c' rolls become flags
+inline Move randomMove(Xoshiro256& moves, int rows, int cols, bool chords) {
+    uint32_t roll = moves.nextBelow(8);
+    char type = roll < 6 ? 'r' : roll == 6 || !chords ? 'f' : 'c';
+    return Move{type, (int)moves.nextBelow((uint32_t)rows), (int)moves.nextBelow((uint32_t)cols)};
+}
+
+// One random game on any board with reset / applyMove / isGameOver / isGameWon
+template <typename Game>
+void playRandomGame(Game& game, uint64_t seed, Xoshiro256& moves, int rows, int cols) {
+    game.reset(seed);
+    while (!game.isGameOver() && !game.isGameWon()) {
+        game.applyMove(randomMove(moves, rows, cols, true));
+    }
+}
+
+// Average seconds per unit of work: timed(i) runs item i and returns the
+// seconds it wants counted and the units it did; repeats for minSeconds
+template <typename Timed>
+double secondsPerUnit(double minSeconds, Timed timed) {
+    double counted = 0;
+    long long units = 0;
+    auto started = chrono::steady_clock::now();
+    for (long long i = 0; units < 3 || secondsSince(started) < minSeconds; i++) {
+        pair<double, long long> part = timed(i);
+        counted += part.first;
+        units += part.second;
+    }
+    return counted / max(1LL, units);
+}
+
+// Correctness and speed of every fast path against ReferenceBoard, on
+// seeded random boards: generation (Minesweeper, BoardArena, BitBoard,
+// PresetGame, the lockstep lanes), then reveal / flag / chord / win after
+// every move of random games, checkWin across the move that wins a board,
+// the border ring across no-guess redeals, then each path's speedup over
+// the reference. One JSON line per check. Without a baseline only correctness is
+// enforced, since speedups vary with machine load: any mismatch returns 1.
+// With a baseline file, a speedup more than VERIFY_TOLERANCE below its
+// recorded value is reported as regressed and, if nothing mismatched,
+// returns 2. A missing baseline file is written from this run.
+const double VERIFY_TOLERANCE = 0.25;
+
+int runVerify(uint64_t seed, double minSeconds, const string& baselinePath) {
+    struct Config { const char* name; int rows, cols, mines, boards, games; };
+    const Config configs[] = {
+        {"beginner", 9, 9, 10, 2000, 500},
+        {"intermediate", 16, 16, 40, 1000, 300},
+        {"expert", 16, 30, 99, 1000, 300},
+        {"bitboard-max", 32, 64, 400, 300, 100},
+        {"custom-300-1pct", 300, 300, 900, 40, 20},
+        {"custom-300-30pct", 300, 300, 27000, 40, 20},
+    };
+    
+    map<string, double> baseline;
+    bool haveBaseline = false;
+    if (!baselinePath.empty()) {
+        ifstream in(baselinePath);
+        string key;
+        double speedup;
+        while (in >> key >> speedup) baseline[key] = speedup;
+        haveBaseline = !baseline.empty();
+    }
+    map<string, double> measured;
+    long long checks = 0, mismatched = 0, regressed = 0;
+    
+    for (const Config& config : configs) {
+        int rows = config.rows, cols = config.cols, mines = config.mines;
+        bool bits = BitBoard::fits(rows, cols);
+        ReferenceBoard reference(rows, cols, mines);
+        Minesweeper game(rows, cols, mines, seed);
+        BitBoard bitboard(bits ? rows : 1, bits ? cols : 1, bits ? mines : 0);
+        LockstepSimulator lockstep(rows, cols, mines, START_ANYWHERE);
+        BoardArena arena(rows, cols, mines, (size_t)config.boards, seed);
+        arena.generate(2);
+        
+        // backend (or check/backend for moves) -> mismatching items, items checked
+        map<string, pair<long long, long long>> generation, play, perMove;
+        map<string, double> seconds;
+        auto tally = [](pair<long long, long long>& entry, bool same) {
+            entry.first += !same;
+            entry.second++;
+        };
+        
+        for (int b = 0; b < config.boards; b++) {
+            uint64_t boardSeed = streamSeed(seed, b);
+            reference.reset(boardSeed);
+            game.reset(boardSeed);
+            tally(generation["minesweeper"], sameBoard(reference, rows, cols, [&](int x, int y) {
+                return game.view().cells[game.index(x, y)];
+            }));
+            BoardView stored = arena.view((size_t)b);
+            tally(generation["arena"], sameBoard(reference, rows, cols, [&](int x, int y) {
+                return stored.cells[stored.index(x, y)];
+            }));
+            if (bits) {
+                bitboard.generate(boardSeed);
+                tally(generation["bitboard"], sameBoard(reference, rows, cols, [&](int x, int y) {
+                    return (uint8_t)(bitboard.adjacentMines(x, y) | (bitboard.isMine(x, y) ? MINE_BIT : 0));
+                }));
+            }
+            withPresetGame(rows, cols, mines, boardSeed, START_ANYWHERE, [&](auto& preset) {
+                BoardView view = preset.view();
+                tally(generation["preset"], sameBoard(reference, rows, cols, [&](int x, int y) {
+                    return view.cells[view.index(x, y)];
+                }));
+            });
+            int lane = b % LockstepSimulator::LANES;
+            if (lane == 0) lockstep.begin(seed, b, min(LockstepSimulator::LANES, config.boards - b));
+            tally(generation["lockstep"], sameBoard(reference, rows, cols, [&](int x, int y) {
+                return lockstep.cellOf(lane, x, y);
+            }));
+        }
+        
+        // Random games, compared after every move: whole boards per game, and
+        // per move the board after each reveal and checkWin after each move.
+        // The bitboard has no chord.
+        auto checkGame = [&](const Move& move) {
+            bool won = game.checkWin();
+            bool same = game.isGameOver() == reference.isGameOver() && game.isGameWon() == reference.isGameWon()
+                     && sameBoard(reference, rows, cols, [&](int x, int y) { return game.view().cells[game.index(x, y)]; });
+            if (move.type == 'r') tally(perMove["reveal/minesweeper"], same);
+            tally(perMove["checkWin/minesweeper"], won == reference.isGameWon());
+            return same;
+        };
+        ReferenceBoard chordless(rows, cols, mines);
+        for (int g = 0; g < config.games; g++) {
+            uint64_t boardSeed = streamSeed(seed, g);
+            Xoshiro256 moves(streamSeed(seed ^ 0xC0FFEEULL, g));
+            reference.reset(boardSeed);
+            game.reset(boardSeed);
+            bool gameSame = true, presetSame = true, isPreset = false;
+            withPresetGame(rows, cols, mines, boardSeed, START_ANYWHERE, [&](auto& preset) {
+                isPreset = true;
+                while (!reference.isGameOver() && !reference.isGameWon()) {
+                    Move move = randomMove(moves, rows, cols, true);
+                    reference.applyMove(move);
+                    game.applyMove(move);
+                    preset.applyMove(move);
+                    BoardView view = preset.view();
+                    gameSame = checkGame(move) && gameSame;
+                    presetSame = presetSame && preset.isGameOver() == reference.isGameOver() && preset.isGameWon() == reference.isGameWon()
+                              && sameBoard(reference, rows, cols, [&](int x, int y) { return view.cells[view.index(x, y)]; });
+                }
+            });
+            while (!isPreset && !reference.isGameOver() && !reference.isGameWon()) {
+                Move move = randomMove(moves, rows, cols, true);
+                reference.applyMove(move);
+                game.applyMove(move);
+                gameSame = checkGame(move) && gameSame;
+            }
+            tally(play["minesweeper"], gameSame);
+            if (isPreset) tally(play["preset"], presetSame);
+            
+            if (bits) {
+                chordless.reset(boardSeed);
+                bitboard.generate(boardSeed);
+                bool same = true;
+                while (!chordless.isGameOver() && !chordless.isGameWon()) {
+                    Move move = randomMove(moves, rows, cols, false);
+                    chordless.applyMove(move);
+                    if (move.type == 'r') bitboard.revealCell(move.x, move.y);
+                    else bitboard.toggleFlag(move.x, move.y);
+                    bool won = bitboard.checkWin() == chordless.isGameWon();
+                    bool moveSame = bitboard.isGameOver() == chordless.isGameOver()
+                                 && sameBoard(chordless, rows, cols, [&](int x, int y) {
+                                        return (uint8_t)(bitboard.adjacentMines(x, y) | (bitboard.isMine(x, y) ? MINE_BIT : 0)
+                                                         | (bitboard.isRevealed(x, y) ? REVEALED_BIT : 0)
+                                                         | (bitboard.isFlagged(x, y) ? FLAGGED_BIT : 0));
+                                    });
+                    if (move.type == 'r') tally(perMove["reveal/bitboard"], moveSame);
+                    tally(perMove["checkWin/bitboard"], won);
+                    same = same && won && moveSame;
+                }
+                tally(play["bitboard"], same);
+            }
+        }
         
-        gameOver = false;
-        gameWon = false;
+        // Random games rarely end in a win, so checkWin also gets the win
+        // transition: open every safe cell but the last in raster order,
+        // then that one, comparing against the reference before and after
+        for (int g = 0; g < config.games; g++) {
+            uint64_t boardSeed = streamSeed(seed, g);
+            reference.reset(boardSeed);
+            game.reset(boardSeed);
+            if (bits) bitboard.generate(boardSeed);
+            int last = -1;
+            for (int k = 0; k < rows * cols; k++) {
+                if (!reference.isMine(k / cols, k % cols)) last = k;
+            }
+            auto open = [&](int k) {
+                reference.revealCell(k / cols, k % cols);
+                game.revealCell(k / cols, k % cols);
+                if (bits) bitboard.revealCell(k / cols, k % cols);
+            };
+            auto compare = [&] {
+                bool won = reference.isGameWon();
+                tally(perMove["checkWin/minesweeper"], game.checkWin() == won);
+                if (bits) tally(perMove["checkWin/bitboard"], bitboard.checkWin() == won);
+            };
+            for (int k = 0; k < last; k++) {
+                if (!reference.isMine(k / cols, k % cols)) open(k);
+            }
+            compare();
+            if (last >= 0) open(last);
+            compare();
+        }
         
-        // Seed random number generator
-        srand(time(nullptr));
+        // No-guess dead ends redeal the board in place. After every redeal
+        // each border cell must still be BORDER_BIT | REVEALED_BIT, and the
+        // count sparse numbering bumps on it may not exceed the mines next
+        // to it, as it would if an earlier layout's count were left behind
+        Minesweeper redealt(rows, cols, mines, seed, START_SAFE);
+        pair<long long, long long> redeal{0, 0};
+        for (int r = 0; r < 8; r++) {
+            redealt.redealAround(redealt.index(rows / 2, cols / 2));
+            BoardView view = redealt.view();
+            int placed = 0;
+            bool ring = true;
+            for (int i = 0; i < rows + 2; i++) {
+                for (int j = 0; j < cols + 2; j++) {
+                    const uint8_t* cell = view.cells + (size_t)i * view.stride + j;
+                    if (i > 0 && j > 0 && i <= rows && j <= cols) {
+                        placed += (*cell & MINE_BIT) != 0;
+                        continue;
+                    }
+                    int adjacent = 0;
+                    for (int dx = -1; dx <= 1; dx++) {
+                        for (int dy = -1; dy <= 1; dy++) {
+                            int ni = i + dx, nj = j + dy;
+                            if (ni > 0 && nj > 0 && ni <= rows && nj <= cols) {
+                                adjacent += (view.cells[(size_t)ni * view.stride + nj] & MINE_BIT) != 0;
+                            }
+                        }
+                    }
+                    ring = ring && (*cell & ~COUNT_MASK) == (BORDER_BIT | REVEALED_BIT)
+                              && (*cell & COUNT_MASK) <= adjacent;
+                }
+            }
+            tally(redeal, ring && placed == mines);
+        }
         
-        // Place mines randomly
-        placeMines();
+        // Timings: generation per board, reveal per cell opened from the
+        // first zero cell, checkWin per call, random games per game
+        auto timedCall = [](auto&& work) {
+            auto t0 = chrono::steady_clock::now();
+            work();
+            return secondsSince(t0);
+        };
+        seconds["generate/reference"] = secondsPerUnit(minSeconds, [&](long long i) {
+            return make_pair(timedCall([&] { reference.reset(seed + i); }), 1LL);
+        });
+        seconds["generate/minesweeper"] = secondsPerUnit(minSeconds, [&](long long i) {
+            return make_pair(timedCall([&] { game.reset(seed + i); }), 1LL);
+        });
+        seconds["generate/arena"] = secondsPerUnit(minSeconds, [&](long long) {
+            BoardArena boards(rows, cols, mines, 64, seed);
+            return make_pair(timedCall([&] { boards.generate(1); }), 64LL);
+        });
+        seconds["generate/lockstep"] = secondsPerUnit(minSeconds, [&](long long i) {
+            return make_pair(timedCall([&] { lockstep.begin(seed, i * 64, 64); }), 64LL);
+        });
+        if (bits) {
+            seconds["generate/bitboard"] = secondsPerUnit(minSeconds, [&](long long i) {
+                return make_pair(timedCall([&] { bitboard.generate(seed + i); }), 1LL);
+            });
+        }
+        withPresetGame(rows, cols, mines, seed, START_ANYWHERE, [&](auto& preset) {
+            seconds["generate/preset"] = secondsPerUnit(minSeconds, [&](long long i) {
+                return make_pair(timedCall([&] { preset.reset(seed + i); }), 1LL);
+            });
+            seconds["play/preset"] = secondsPerUnit(minSeconds, [&](long long i) {
+                Xoshiro256 moves(streamSeed(seed, i));
+                return make_pair(timedCall([&] { playRandomGame(preset, seed + i, moves, rows, cols); }), 1LL);
+            });
+        });
+        seconds["play/reference"] = secondsPerUnit(minSeconds, [&](long long i) {
+            Xoshiro256 moves(streamSeed(seed, i));
+            return make_pair(timedCall([&] { playRandomGame(reference, seed + i, moves, rows, cols); }), 1LL);
+        });
+        seconds["play/minesweeper"] = secondsPerUnit(minSeconds, [&](long long i) {
+            Xoshiro256 moves(streamSeed(seed, i));
+            return make_pair(timedCall([&] { playRandomGame(game, seed + i, moves, rows, cols); }), 1LL);
+        });
         
-        // Calculate numbers for each cell
-        calculateNumbers();
+        // Reveals start from the first zero cell of board seed + i, the same
+        // cell on every backend; boards without one are skipped
+        auto firstZero = [&](int& x, int& y) {
+            for (x = 0; x < rows; x++) {
+                for (y = 0; y < cols; y++) {
+                    if (!reference.isMine(x, y) && reference.adjacentMines(x, y) == 0) return true;
+                }
+            }
+            return false;
+        };
+        seconds["reveal/reference"] = secondsPerUnit(minSeconds, [&](long long i) {
+            reference.reset(seed + i);
+            int x, y;
+            if (!firstZero(x, y)) return make_pair(0.0, 0LL);
+            double elapsed = timedCall([&] { reference.revealCell(x, y); });
+            long long opened = 0;
+            for (int r = 0; r < rows; r++) {
+                for (int c = 0; c < cols; c++) opened += (reference.cell(r, c) & REVEALED_BIT) != 0;
+            }
+            return make_pair(elapsed, opened);
+        });
+        seconds["reveal/minesweeper"] = secondsPerUnit(minSeconds, [&](long long i) {
+            reference.reset(seed + i);
+            game.reset(seed + i);
+            int x, y;
+            if (!firstZero(x, y)) return make_pair(0.0, 0LL);
+            size_t opened = 0;
+            double elapsed = timedCall([&] { opened = game.revealCell(x, y).size(); });
+            return make_pair(elapsed, (long long)opened);
+        });
+        if (bits) {
+            seconds["reveal/bitboard"] = secondsPerUnit(minSeconds, [&](long long i) {
+                reference.reset(seed + i);
+                bitboard.generate(seed + i);
+                int x, y;
+                if (!firstZero(x, y)) return make_pair(0.0, 0LL);
+                int opened = 0;
+                double elapsed = timedCall([&] { opened = bitboard.revealCell(x, y); });
+                return make_pair(elapsed, (long long)opened);
+            });
+        }
+        
+        // checkWin on a board left half open, 256 calls per sample
+        reference.reset(seed);
+        game.reset(seed);
+        if (bits) bitboard.generate(seed);
+        int x, y;
+        if (firstZero(x, y)) {
+            reference.revealCell(x, y);
+            game.revealCell(x, y);
+            if (bits) bitboard.revealCell(x, y);
+        }
+        // Every call follows a flag toggle on one hidden cell. The toggle
+        // changes nothing a win check reads, but it stops the compiler
+        // from running a side-effect-free check once for the whole loop.
+        int hx = -1, hy = -1;
+        for (int r = 0; r < rows && hx < 0; r++) {
+            for (int c = 0; c < cols; c++) {
+                if (!(reference.cell(r, c) & REVEALED_BIT)) {
+                    hx = r; hy = c;
+                    break;
+                }
+            }
+        }
+        long long won = 0;
+        auto repeated = [&](auto&& toggle, auto&& check) {
+            return make_pair(timedCall([&] {
+                for (int k = 0; k < 256; k++) {
+                    toggle();
+                    won += check();
+                }
+            }), 256LL);
+        };
+        if (hx >= 0) {
+            seconds["checkWin/reference"] = secondsPerUnit(minSeconds, [&](long long) {
+                return repeated([&] { reference.toggleFlag(hx, hy); }, [&] { return reference.checkWin(); });
+            });
+            seconds["checkWin/minesweeper"] = secondsPerUnit(minSeconds, [&](long long) {
+                return repeated([&] { game.toggleFlag(hx, hy); }, [&] { return game.checkWin(); });
+            });
+            if (bits) {
+                seconds["checkWin/bitboard"] = secondsPerUnit(minSeconds, [&](long long) {
+                    return repeated([&] { bitboard.toggleFlag(hx, hy); }, [&] { return bitboard.checkWin(); });
+                });
+            }
+        }
+        
+        // One line per check and fast path
+        auto report = [&](const string& check, const string& backend, long long mismatches, long long items) {
+            string key = string(config.name) + "/" + check + "/" + backend;
+            double speedup = 0;
+            if (seconds.count(check + "/" + backend) && seconds[check + "/" + backend] > 0) {
+                speedup = seconds[check + "/reference"] / seconds[check + "/" + backend];
+                measured[key] = speedup;
+            }
+            bool timed = measured.count(key) > 0;
+            bool floored = timed && haveBaseline && baseline.count(key);
+            double floor = floored ? baseline[key] * (1 - VERIFY_TOLERANCE) : 0.0;
+            const char* status = mismatches > 0 ? "mismatch" : floored && speedup < floor ? "regressed" : "ok";
+            mismatched += mismatches > 0;
+            regressed += status[0] == 'r';
+            checks++;
+            cout << "{\"verify\":\"" << check << "\",\"backend\":\"" << backend << "\",\"config\":\"" << config.name
+                 << "\",\"rows\":" << rows << ",\"cols\":" << cols << ",\"mines\":" << mines << ",\"seed\":" << seed
+                 << ",\"checked\":" << items << ",\"mismatches\":" << mismatches;
+            if (timed) cout << ",\"speedup\":" << speedup;
+            if (floored) cout << ",\"min_speedup\":" << floor;
+            cout << ",\"status\":\"" << status << "\"}\n";
+        };
+        for (auto& entry : generation) report("generate", entry.first, entry.second.first, entry.second.second);
+        report("redeal", "minesweeper", redeal.first, redeal.second);
+        for (auto& entry : play) {
+            if (entry.first != "bitboard") report("play", entry.first, entry.second.first, entry.second.second);
+        }
+        report("reveal", "minesweeper", perMove["reveal/minesweeper"].first, perMove["reveal/minesweeper"].second);
+        report("checkWin", "minesweeper", perMove["checkWin/minesweeper"].first, perMove["checkWin/minesweeper"].second);
+        if (bits) {
+            report("reveal", "bitboard", perMove["reveal/bitboard"].first, perMove["reveal/bitboard"].second);
+            report("checkWin", "bitboard", perMove["checkWin/bitboard"].first, perMove["checkWin/bitboard"].second);
+        }
     }
     
-    // DSA: Random placement algorithm with collision detection
-    void placeMines() {
-        int minesPlaced = 0;
-        while (minesPlaced < totalMines) {
-            int x = rand() % rows;
-            int y = rand() % cols;
+    if (!baselinePath.empty() && !haveBaseline) {
+        ofstream out(baselinePath);
+        for (auto& entry : measured) out << entry.first << " " << entry.second << "\n";
+        cerr << "Wrote baseline " << baselinePath << "\n";
+    }
+    cerr << "verify: " << checks << " checks, " << mismatched << " mismatched, " << regressed << " regressed\n";
+    return mismatched > 0 ? 1 : regressed > 0 ? 2 : 0;
+}
+
+// Bot play: the solver picks every move; when nothing can be deduced it
+// guesses the cell the probability estimator rates least likely to be a
+// mine. Reports the win rate and the solver and estimator latencies; with
+// a log, every game is also recorded to it.
+int runAutoplay(long long games, int rows, int cols, int mines, uint64_t seed, StartMode start,
+                GameLogWriter* log) {
+    Solver solver;
+    ProbabilityEstimator estimator(ProbabilityEstimator::Settings{1, 0.01, 0.05, seed ^ 0x5DEECE66DULL});
+    long long wins = 0, moves = 0, guesses = 0;
+    double solverSeconds = 0, slowestMove = 0, estimatorSeconds = 0, slowestEstimate = 0;
+    long long passes = 0, repairs = 0, regenerations = 0, unsolvable = 0;
+    double generationSeconds = 0;
+    long long boardValues = 0;
+    LeaderboardService leaderboard;
+    Leaderboard* board = leaderboard.find(rows, cols, mines);
+    
+    Minesweeper game(rows, cols, mines, streamSeed(seed, 0), start);
+    game.trackFrontier();
+    GameRecord record;
+    for (long long g = 0; g < games; g++) {
+        if (g > 0) game.reset(streamSeed(seed, g));
+        if (log) record.begin(rows, cols, mines, start, game.getSeed());
+        solver.attach(game.view());
+        int target = game.index(rows / 2, cols / 2);
+        while (!game.isGameOver() && !game.isGameWon()) {
+            Move next{'r', game.rowOf(target), game.colOf(target)};
+            MoveResult result = game.applyMove(next);
+            if (log && result.status == MOVE_APPLIED) record.add(next);
+            moves++;
             
-            // Check if cell doesn't already contain a mine
-            if (grid[x][y] != -1) {
-                grid[x][y] = -1;  // -1 represents a mine
-                minesPlaced++;
+            auto started = chrono::steady_clock::now();
+            solver.update(*result.changed);
+            target = solver.nextSafe();
+            double elapsed = secondsSince(started);
+            solverSeconds += elapsed;
+            slowestMove = max(slowestMove, elapsed);
+            
+            if (target < 0 && !game.isGameOver() && !game.isGameWon()) {
+                // Stuck: guess the cell least likely to be a mine
+                guesses++;
+                started = chrono::steady_clock::now();
+                estimator.estimate(game.view(), mines, &solver);
+                target = estimator.safestCell();
+                elapsed = secondsSince(started);
+                estimatorSeconds += elapsed;
+                slowestEstimate = max(slowestEstimate, elapsed);
             }
         }
+        wins += game.isGameWon();
+        if (log) log->append(record);
+        boardValues += game.getBoardValue();
+        if (board && game.isGameWon()) {
+            board->record(Leaderboard::Entry{game.getPlaySeconds(), game.getBoardValue(), game.getSeed()});
+        }
+        
+        const GenerationReport& report = game.getGenerationReport();
+        passes += report.passes;
+        repairs += report.repairs;
+        regenerations += report.regenerations;
+        unsolvable += start == START_NO_GUESS && !report.solvable;
+        generationSeconds += report.seconds;
     }
     
-    // DSA: Graph traversal to calculate adjacent mine counts
-    void calculateNumbers() {
-        for (int i = 0; i < rows; i++) {
-            for (int j = 0; j < cols; j++) {
-                if (grid[i][j] != -1) {  // If not a mine
-                    int count = 0;
-                    
-                    // Check all 8 adjacent cells
-                    for (int k = 0; k < 8; k++) {
-                        int newX = i + dx[k];
-                        int newY = j + dy[k];
-                        
-                        // Check bounds and if adjacent cell is a mine
-                        if (isValid(newX, newY) && grid[newX][newY] == -1) {
-                            count++;
-                        }
-                    }
-                    
-                    grid[i][j] = count;
-                }
-            }
+    cout << "games=" << games << " wins=" << wins
+         << " win_rate=" << (games > 0 ? (double)wins / games : 0) << " moves=" << moves
+         << " guesses=" << guesses << " solver_us_per_move=" << (moves > 0 ? solverSeconds * 1e6 / moves : 0)
+         << " solver_us_max=" << slowestMove * 1e6
+         << " estimator_ms_per_guess=" << (guesses > 0 ? estimatorSeconds * 1e3 / guesses : 0)
+         << " estimator_ms_max=" << slowestEstimate * 1e3
+         << " bbbv_per_board=" << (games > 0 ? (double)boardValues / games : 0) << "\n";
+    if (board && board->count() > 0) {
+        // Rank queries over the spread of recorded times
+        const int QUERIES = 100000;
+        double fastest = board->secondsAtPercentile(0), slowest = board->secondsAtPercentile(100);
+        uint64_t rankSum = 0;
+        auto started = chrono::steady_clock::now();
+        for (int q = 0; q < QUERIES; q++) {
+            rankSum += board->rankOf(fastest + (slowest - fastest) * q / QUERIES);
         }
+        double querySeconds = secondsSince(started);
+        const Leaderboard::Entry& best = board->top().front();
+        cout << "leaderboard=" << LeaderboardService::presetName(LeaderboardService::presetOf(rows, cols, mines))
+             << " ranked=" << board->count() << " best_s=" << best.seconds << " best_bbbv=" << best.boardValue
+             << " best_seed=" << best.seed << " median_s=" << board->secondsAtPercentile(50)
+             << " p90_s=" << board->secondsAtPercentile(90) << " rank_query_ns=" << querySeconds * 1e9 / QUERIES
+             << " mean_rank=" << (double)rankSum / QUERIES << "\n";
+    }
+    if (start == START_NO_GUESS && games > 0) {
+        cout << "no_guess_passes_per_board=" << (double)passes / games
+             << " repairs_per_board=" << (double)repairs / games << " regenerations=" << regenerations
+             << " unsolvable=" << unsolvable << " generation_ms_per_board=" << generationSeconds * 1e3 / games << "\n";
     }
+    return 0;
+}
+
+// Lockstep bot play: workers claim batches of LockstepSimulator::LANES games
+// and play each batch together. The bot only applies single-cell rules and
+// guesses uniformly when stuck, so it wins less often than --autoplay but
+// plays far more games per second. Results do not depend on the thread
+// count; per-game lines "game moves guesses won" go to outPath when given.
+int runSimulate(long long games, int threads, const string& outPath, int rows, int cols, int mines,
+                uint64_t seed, StartMode start) {
+    const int LANES = LockstepSimulator::LANES;
+    vector<LockstepSimulator::Result> results((size_t)games);
+    long long batches = (games + LANES - 1) / LANES;
+    atomic<long long> nextBatch(0);
     
-    // Helper function to check if coordinates are valid
-    bool isValid(int x, int y) {
-        return x >= 0 && x < rows && y >= 0 && y < cols;
+    auto started = chrono::steady_clock::now();
+    auto worker = [&]() {
+        LockstepSimulator simulator(rows, cols, mines, start);
+        while (true) {
+            long long batch = nextBatch.fetch_add(1);
+            if (batch >= batches) break;
+            long long first = batch * LANES;
+            simulator.play(seed, first, (int)min<long long>(LANES, games - first), &results[first]);
+        }
+    };
+    vector<thread> pool;
+    for (int t = 1; t < threads && t < batches; t++) {
+        pool.emplace_back(worker);
     }
+    worker();
+    for (thread& t : pool) {
+        t.join();
+    }
+    double seconds = secondsSince(started);
     
-    // DSA: Flood Fill Algorithm using DFS
-    void revealCell(int x, int y) {
-        if (!isValid(x, y) || revealed[x][y] || flagged[x][y]) {
-            return;
+    long long wins = 0, moves = 0, guesses = 0;
+    int fewestMoves = INT_MAX, mostMoves = 0;
+    for (const LockstepSimulator::Result& result : results) {
+        wins += result.won;
+        moves += result.moves;
+        guesses += result.guesses;
+        fewestMoves = min(fewestMoves, result.moves);
+        mostMoves = max(mostMoves, result.moves);
+    }
+    
+    if (!outPath.empty()) {
+        FILE* out = fopen(outPath.c_str(), "w");
+        if (!out) {
+            cerr << "Cannot open output file: " << outPath << "\n";
+            return 1;
         }
-        
-        revealed[x][y] = true;
-        
-        // If clicked on a mine, game over
-        if (grid[x][y] == -1) {
-            gameOver = true;
-            return;
+        for (long long g = 0; g < games; g++) {
+            fprintf(out, "%lld %d %d %d\n", g, results[g].moves, results[g].guesses, (int)results[g].won);
         }
-        
-        // If cell has no adjacent mines, reveal all adjacent cells (flood fill)
-        if (grid[x][y] == 0) {
-            for (int k = 0; k < 8; k++) {
-                int newX = x + dx[k];
-                int newY = y + dy[k];
-                revealCell(newX, newY);  // Recursive DFS
-            }
+        fclose(out);
+    }
+    
+    cout << "games=" << games << " wins=" << wins << " win_rate=" << (double)wins / games
+         << " moves=" << moves << " guesses=" << guesses << " moves_per_game=" << (double)moves / games
+         << " moves_min=" << fewestMoves << " moves_max=" << mostMoves << " threads=" << threads
+         << " seconds=" << seconds << " games_per_sec=" << (seconds > 0 ? (long long)(games / seconds) : 0) << "\n";
+    return 0;
+}
+
+// Bulk board generation: fill an arena across threads, report the rate and a
+// checksum, and optionally dump it (header: "MSPL", then rows, cols, mines
+// as uint32 and count, base seed as uint64, all little-endian; then the
+// padded cell bytes of every board in order)
+int runGenerate(size_t count, int threads, const string& outPath, int rows, int cols, int mines, uint64_t seed) {
+    auto started = chrono::steady_clock::now();
+    BoardArena arena(rows, cols, mines, count, seed);
+    arena.generate(threads);
+    double seconds = secondsSince(started);
+    
+    // FNV-1a over the whole arena: equal for any thread count
+    uint64_t checksum = 0xCBF29CE484222325ULL;
+    const uint8_t* bytes = arena.data();
+    for (size_t i = 0, total = arena.boardSize() * count; i < total; i++) {
+        checksum = (checksum ^ bytes[i]) * 0x100000001B3ULL;
+    }
+    
+    if (!outPath.empty()) {
+        FILE* out = fopen(outPath.c_str(), "wb");
+        if (!out) {
+            cerr << "Cannot open output file: " << outPath << "\n";
+            return 1;
         }
+        uint8_t header[32] = {'M', 'S', 'P', 'L'};
+        uint64_t fields[] = {(uint64_t)rows, (uint64_t)cols, (uint64_t)mines, (uint64_t)count, seed};
+        int widths[] = {4, 4, 4, 8, 8};
+        int offset = 4;
+        for (int f = 0; f < 5; f++) {
+            for (int b = 0; b < widths[f]; b++) header[offset++] = (uint8_t)(fields[f] >> (8 * b));
+        }
+        fwrite(header, 1, sizeof(header), out);
+        fwrite(arena.data(), 1, arena.boardSize() * count, out);
+        fclose(out);
     }
     
-    // Toggle flag on a cell
-    void toggleFlag(int x, int y) {
-        if (!isValid(x, y) || revealed[x][y]) {
+    cout << "boards=" << count << " threads=" << threads << " seconds=" << seconds
+         << " boards_per_sec=" << (seconds > 0 ? (long long)(count / seconds) : 0)
+         << " checksum=" << hex << checksum << dec << "\n";
+    return 0;
+}
+
+#if defined(__linux__)
+// DSA: Multi-game server. Every worker thread owns a SO_REUSEPORT listening
+// socket, an epoll instance and the games of its connections, so the kernel
+// spreads connections over the workers and no state or lock is shared.
+// Protocol: one command per line in the batch grammar (r x y, f x y,
+// c x y, n [seed], q), plus w <id> to watch any game, and exactly one
+// reply line per command:
+//   <applied|nochange|invalid|ended> <playing|won|lost> <n> x:y:c ...
+//     (the n changed cells; c is 0-8, * for a mine, F flagged, . hidden)
+//   new <seed>       after n
+//   board <id> <version> <playing|won|lost> <rows> <cols> <cells>
+//                    after w: every cell row by row, in the same letters
+//   bye              after q, then the connection closes
+//   error unknown    after w with an id that is not being played
+//   error busy       after w when the game has too many spectators right
+//                    now; retrying later can succeed
+//   error malformed  for anything else
+// A connection starts with "hello <rows> <cols> <mines> <seed> <id>".
+// Games on other workers are watched through their SnapshotPublisher, so
+// a spectator never stalls the owning worker; the id registry is only
+// locked on connect, disconnect and watch.
+class GameServer {
+private:
+    struct Connection {
+        unique_ptr<Minesweeper> game;
+        shared_ptr<SnapshotPublisher> snapshots;
+        GameRecord record;
+        uint64_t id;
+        string in, out;
+        bool closing;
+    };
+    
+    static const size_t MAX_LINE = 256;           // longer lines drop the client
+    static atomic<bool> stopping;
+    
+    int port, rows, cols, mines;
+    uint64_t seed;
+    StartMode start;
+    atomic<long long> connectionsServed, commandsServed;
+    atomic<int> failedWorkers;
+    
+    mutex registryLock;              // guards watchable
+    unordered_map<uint64_t, shared_ptr<SnapshotPublisher>> watchable;
+    atomic<uint64_t> nextGameId;
+    GameLogWriter* log;              // records every game with a move, if set
+    
+    static atomic<bool> dumpRequested;
+    
+    static void onSignal(int) { stopping = true; }
+    static void onDumpSignal(int) { dumpRequested = true; }
+    
+    static void appendInt(string& out, long long value) {
+        char text[24];
+        out.append(text, (size_t)snprintf(text, sizeof(text), "%lld", value));
+    }
+    
+    // Reply letter of a cell byte: 0-8, * for a revealed mine, F, or .
+    static char cellLetter(uint8_t cell) {
+        return (cell & FLAGGED_BIT) ? 'F' : !(cell & REVEALED_BIT) ? '.'
+             : (cell & MINE_BIT) ? '*' : (char)('0' + (cell & COUNT_MASK));
+    }
+    
+    // Append the latest published state of game id
+    void appendBoard(string& out, uint64_t id) {
+        shared_ptr<SnapshotPublisher> publisher;
+        {
+            lock_guard<mutex> guard(registryLock);
+            auto found = watchable.find(id);
+            if (found != watchable.end()) publisher = found->second;
+        }
+        if (!publisher) {
+            out += "error unknown\n";
             return;
         }
-        
-        flagged[x][y] = !flagged[x][y];
+        SnapshotPublisher::Reader snapshot(*publisher);
+        if (!snapshot.get()) {
+            out += snapshot.busy() ? "error busy\n" : "error unknown\n";
+            return;
+        }
+        out += "board ";
+        appendInt(out, (long long)id);
+        out += ' ';
+        appendInt(out, (long long)snapshot->version);
+        out += snapshot->gameWon ? " won " : snapshot->gameOver ? " lost " : " playing ";
+        appendInt(out, snapshot->rows);
+        out += ' ';
+        appendInt(out, snapshot->cols);
+        out += ' ';
+        for (int x = 0; x < snapshot->rows; x++) {
+            for (int y = 0; y < snapshot->cols; y++) out += cellLetter(snapshot->cell(x, y));
+        }
+        out += '\n';
     }
     
-    // Check if game is won
-    bool checkWin() {
-        int revealedCount = 0;
-        int correctFlags = 0;
+    
+    void beginRecord(Connection& conn) {
+        Minesweeper& game = *conn.game;
+        if (log) conn.record.begin(game.getRows(), game.getCols(), game.getTotalMines(), game.getStartMode(), game.getSeed());
+    }
+    
+    void finishRecord(Connection& conn) {
+        if (log && conn.record.moveCount() > 0) log->append(conn.record);
+    }
+    
+    // Execute one command line and append its reply
+    void execute(Connection& conn, const char* line, const char* last) {
+        static const char* statusNames[] = {"applied", "nochange", "invalid", "ended"};
+        char type;
+        long long args[2];
+        int argc;
+        if (!parseCommand(line, last, type, args, argc)) return;
+        commandsServed.fetch_add(1, memory_order_relaxed);
         
-        for (int i = 0; i < rows; i++) {
-            for (int j = 0; j < cols; j++) {
-                if (revealed[i][j] && grid[i][j] != -1) {
-                    revealedCount++;
-                }
-                if (flagged[i][j] && grid[i][j] == -1) {
-                    correctFlags++;
-                }
+        Minesweeper& game = *conn.game;
+        if (type == 'q' && argc == 0) {
+            conn.out += "bye\n";
+            conn.closing = true;
+        } else if (type == 'n' && argc <= 1) {
+            uint64_t gameSeed = argc == 1 ? (uint64_t)args[0] : streamSeed(game.getSeed(), 1);
+            finishRecord(conn);
+            game.reset(gameSeed);
+            beginRecord(conn);
+            conn.snapshots->publishAll(game);
+            conn.out += "new ";
+            conn.out += to_string(gameSeed);
+            conn.out += '\n';
+        } else if ((type == 'r' || type == 'f' || type == 'c') && argc == 2 && args[0] >= INT32_MIN && args[0] <= INT32_MAX
+                   && args[1] >= INT32_MIN && args[1] <= INT32_MAX) {
+            Move next{type, (int)args[0], (int)args[1]};
+            MoveResult result = game.applyMove(next);
+            if (result.status == MOVE_APPLIED) {
+                conn.snapshots->publish(game, *result.changed);
+                if (log) conn.record.add(next);
             }
+            conn.out += statusNames[result.status];
+            conn.out += result.gameWon ? " won " : result.gameOver ? " lost " : " playing ";
+            appendInt(conn.out, (long long)result.changed->size());
+            for (int idx : *result.changed) {
+                int x = game.rowOf(idx), y = game.colOf(idx);
+                conn.out += ' ';
+                appendInt(conn.out, x);
+                conn.out += ':';
+                appendInt(conn.out, y);
+                conn.out += ':';
+                conn.out += cellLetter(game.view().cells[idx]);
+            }
+            conn.out += '\n';
+        } else if (type == 'w' && argc == 1 && args[0] >= 0) {
+            appendBoard(conn.out, (uint64_t)args[0]);
+        } else {
+            conn.out += "error malformed\n";
         }
-        
-        // Win condition: all non-mine cells revealed
-        if (revealedCount == (rows * cols - totalMines)) {
-            gameWon = true;
-            return true;
-        }
-        
-        return false;
     }
     
-    // Display the game grid
-    void displayGrid(bool showMines = false) {
-        cout << "\n   ";
-        for (int j = 0; j < cols; j++) {
-            cout << setw(3) << j;
-        }
-        cout << "\n";
-        
-        for (int i = 0; i < rows; i++) {
-            cout << setw(2) << i << " ";
-            for (int j = 0; j < cols; j++) {
-                if (flagged[i][j] && !showMines) {
-                    cout << " F ";
-                } else if (!revealed[i][j] && !showMines) {
-                    cout << " . ";
-                } else if (grid[i][j] == -1) {
-                    cout << " * ";
-                } else if (grid[i][j] == 0) {
-                    cout << "   ";
-                } else {
-                    cout << " " << grid[i][j] << " ";
-                }
-            }
-            cout << "\n";
+    // Run every complete line in the input buffer; false drops the client
+    bool processInput(Connection& conn) {
+        size_t begin = 0;
+        while (!conn.closing) {
+            size_t newline = conn.in.find('\n', begin);
+            if (newline == string::npos) break;
+            execute(conn, conn.in.data() + begin, conn.in.data() + newline);
+            begin = newline + 1;
         }
-        cout << "\n";
+        conn.in.erase(0, begin);
+        return conn.in.size() <= MAX_LINE;
     }
     
-    // Display game statistics
-    void displayStats() {
-        int flagsUsed = 0;
-        int cellsRevealed = 0;
-        
-        for (int i = 0; i < rows; i++) {
-            for (int j = 0; j < cols; j++) {
-                if (flagged[i][j]) flagsUsed++;
-                if (revealed[i][j]) cellsRevealed++;
+    // Send as much pending output as the socket takes; false on error
+    static bool flushOutput(int fd, Connection& conn) {
+        size_t sent = 0;
+        while (sent < conn.out.size()) {
+            ssize_t n = send(fd, conn.out.data() + sent, conn.out.size() - sent, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                if (errno == EINTR) continue;
+                return false;
             }
+            sent += (size_t)n;
         }
-        
-        cout << "Mines: " << totalMines << " | Flags Used: " << flagsUsed 
-             << " | Cells Revealed: " << cellsRevealed << "/" << (rows * cols - totalMines) << "\n";
+        conn.out.erase(0, sent);
+        return true;
     }
     
-    // Main game loop
-    void playGame() {
-        cout << "Welcome to Minesweeper!\n";
-        cout << "Commands:\n";
-        cout << "  r x y - Reveal cell at (x,y)\n";
-        cout << "  f x y - Flag/unflag cell at (x,y)\n";
-        cout << "  q     - Quit game\n\n";
+    void worker(int id) {
+        int listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        int one = 1;
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons((uint16_t)port);
+        if (listener < 0 || setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) < 0
+            || setsockopt(listener, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) < 0
+            || ::bind(listener, (sockaddr*)&address, sizeof(address)) < 0 || listen(listener, SOMAXCONN) < 0) {
+            cerr << "Worker " << id << ": cannot listen on port " << port << ": " << strerror(errno) << "\n";
+            if (listener >= 0) ::close(listener);
+            failedWorkers++;
+            return;
+        }
         
-        while (!gameOver && !gameWon) {
-            displayGrid();
-            displayStats();
-            
-            cout << "Enter command: ";
-            char command;
-            cin >> command;
-            
-            if (command == 'q') {
-                cout << "Thanks for playing!\n";
-                return;
+        int poller = epoll_create1(0);
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = listener;
+        epoll_ctl(poller, EPOLL_CTL_ADD, listener, &event);
+        
+        unordered_map<int, Connection> connections;
+        GamePool pool;               // games of closed connections are recycled
+        pool.reserve(rows, cols, mines, start, 64);
+        uint64_t gamesStarted = 0;
+        auto drop = [&](int fd) {
+            epoll_ctl(poller, EPOLL_CTL_DEL, fd, nullptr);
+            ::close(fd);
+            auto found = connections.find(fd);
+            finishRecord(found->second);
+            {
+                lock_guard<mutex> guard(registryLock);
+                watchable.erase(found->second.id);
             }
-            
-            if (command == 'r' || command == 'f') {
-                int x, y;
-                cin >> x >> y;
-                
-                if (!isValid(x, y)) {
-                    cout << "Invalid coordinates!\n";
+            pool.release(move(found->second.game));
+            connections.erase(found);
+        };
+        
+        epoll_event events[256];
+        char block[1 << 16];
+        while (!stopping) {
+            if (id == 0 && dumpRequested.exchange(false)) dumpInstrumentation(cerr, false);
+            int ready = epoll_wait(poller, events, 256, 200);
+            for (int e = 0; e < ready; e++) {
+                int fd = events[e].data.fd;
+                if (fd == listener) {
+                    int client;
+                    while ((client = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK)) >= 0) {
+                        Connection& conn = connections[client];
+                        conn.closing = false;
+                        uint64_t gameSeed = streamSeed(seed, (uint64_t)id << 40 | gamesStarted++);
+                        conn.game = pool.acquire(rows, cols, mines, gameSeed, start);
+                        beginRecord(conn);
+                        conn.id = nextGameId++;
+                        conn.snapshots = make_shared<SnapshotPublisher>();
+                        conn.snapshots->publishAll(*conn.game);
+                        {
+                            lock_guard<mutex> guard(registryLock);
+                            watchable[conn.id] = conn.snapshots;
+                        }
+                        conn.out = "hello " + to_string(rows) + " " + to_string(cols) + " "
+                                 + to_string(mines) + " " + to_string(gameSeed) + " " + to_string(conn.id) + "\n";
+                        event.events = EPOLLIN;
+                        event.data.fd = client;
+                        epoll_ctl(poller, EPOLL_CTL_ADD, client, &event);
+                        connectionsServed++;
+                        if (!flushOutput(client, conn)) drop(client);
+                    }
                     continue;
                 }
                 
-                if (command == 'r') {
-                    revealCell(x, y);
-                } else {
-                    toggleFlag(x, y);
+                auto found = connections.find(fd);
+                if (found == connections.end()) continue;
+                Connection& conn = found->second;
+                bool alive = !(events[e].events & EPOLLERR);
+                if (alive && (events[e].events & (EPOLLIN | EPOLLHUP))) {
+                    while (true) {
+                        ssize_t n = recv(fd, block, sizeof(block), 0);
+                        if (n > 0) {
+                            conn.in.append(block, (size_t)n);
+                            if (!processInput(conn)) {
+                                alive = false;
+                                break;
+                            }
+                            continue;
+                        }
+                        if (n < 0 && errno == EINTR) continue;
+                        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) alive = false;
+                        break;
+                    }
                 }
-                
-                if (checkWin()) {
-                    gameWon = true;
+                alive = flushOutput(fd, conn) && alive;
+                if (!alive || (conn.closing && conn.out.empty())) {
+                    drop(fd);
+                    continue;
                 }
-            } else {
-                cout << "Invalid command!\n";
+                // Wait for writability only while a reply is backed up
+                event.events = conn.out.empty() ? EPOLLIN : EPOLLIN | EPOLLOUT;
+                event.data.fd = fd;
+                epoll_ctl(poller, EPOLL_CTL_MOD, fd, &event);
             }
         }
         
-        // Game ended - show final state
-        displayGrid(true);
-        
-        if (gameWon) {
-            cout << "🎉 Congratulations! You won! 🎉\n";
-        } else {
-            cout << "💥 Game Over! You hit a mine! 💥\n";
+        for (auto& entry : connections) {
+            finishRecord(entry.second);
+            ::close(entry.first);
         }
+        ::close(poller);
+        ::close(listener);
     }
     
-    // Get game state
-    bool isGameOver() { return gameOver; }
-    bool isGameWon() { return gameWon; }
+public:
+    GameServer(int listenPort, int r, int c, int m, uint64_t baseSeed, StartMode startMode,
+               GameLogWriter* gameLog = nullptr)
+        : port(listenPort), rows(r), cols(c), mines(m), seed(baseSeed), start(startMode),
+          connectionsServed(0), commandsServed(0), failedWorkers(0), nextGameId(1), log(gameLog) {}
+    
+    // Serve until SIGINT/SIGTERM, then print totals
+    int run(int threads) {
+        stopping = false;
+        signal(SIGINT, onSignal);
+        signal(SIGTERM, onSignal);
+        signal(SIGUSR1, onDumpSignal);
+        cout << "Serving " << rows << "x" << cols << " games with " << mines << " mines on port "
+             << port << " (" << threads << " workers)" << endl;
+        
+        vector<thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back(&GameServer::worker, this, t);
+        }
+        for (thread& t : workers) t.join();
+        
+        cout << "connections=" << connectionsServed << " commands=" << commandsServed << "\n";
+        return failedWorkers == threads ? 1 : 0;
+    }
 };
 
-// Function to get difficulty level
-void getDifficultySettings(int& rows, int& cols, int& mines) {
-    cout << "Select difficulty:\n";
-    cout << "1. Beginner (9x9, 10 mines)\n";
-    cout << "2. Intermediate (16x16, 40 mines)\n";
-    cout << "3. Expert (30x16, 99 mines)\n";
-    cout << "4. Custom\n";
-    cout << "Enter choice (1-4): ";
+atomic<bool> GameServer::stopping(false);
+atomic<bool> GameServer::dumpRequested(false);
+#endif
+
+// Shared-world load run: `players` players spread along one row of an
+// endless board, each subscribed to the tiles around its spot and clicking
+// at random nearby, on a world split into `shards` shards. Prints the
+// totals and one line per shard, so the load of each can be compared.
+int runWorld(int shardCount, int players, uint64_t seed, double density) {
+    if (density < ChunkedBoard::MIN_ENDLESS_DENSITY || density >= 1) {
+        cerr << "Endless density must be in [" << ChunkedBoard::MIN_ENDLESS_DENSITY << ", 1)\n";
+        return 1;
+    }
+    const int MOVES = 200, REACH = 48, SPACING = 1000;
+    ShardedWorld world(seed, density, shardCount);
+    struct Player {
+        long long x, y;
+        int id;
+        long long deltas;
+    };
+    vector<Player> crowd;
+    for (int p = 0; p < players; p++) {
+        Player player{0, (long long)p * SPACING, world.addSubscriber(), 0};
+        world.findOpening(player.x, player.y);
+        long long tx = ChunkedBoard::floorDiv(player.x, ChunkedBoard::TILE);
+        long long ty = ChunkedBoard::floorDiv(player.y, ChunkedBoard::TILE);
+        for (int dx = -1; dx <= 1; dx++) {
+            for (int dy = -1; dy <= 1; dy++) world.subscribe(player.id, tx + dx, ty + dy);
+        }
+        crowd.push_back(player);
+    }
     
-    int choice;
-    cin >> choice;
+    Xoshiro256 rng(seed);
+    auto started = chrono::steady_clock::now();
+    for (Player& player : crowd) world.reveal(player.x, player.y);
+    for (int m = 0; m < MOVES; m++) {
+        for (Player& player : crowd) {
+            long long x = player.x + (long long)rng.nextBelow(2 * REACH + 1) - REACH;
+            long long y = player.y + (long long)rng.nextBelow(2 * REACH + 1) - REACH;
+            if (rng.nextBelow(8) == 0) world.toggleFlag(x, y);
+            else world.reveal(x, y);
+        }
+        for (Player& player : crowd) {
+            player.deltas += (long long)world.mailbox(player.id).size();
+            world.mailbox(player.id).clear();
+        }
+    }
+    double seconds = secondsSince(started);
     
-    switch (choice) {
-        case 1:
-            rows = 9; cols = 9; mines = 10;
-            break;
-        case 2:
-            rows = 16; cols = 16; mines = 40;
-            break;
-        case 3:
-            rows = 16; cols = 30; mines = 99;
-            break;
-        case 4:
-            cout << "Enter rows: ";
-            cin >> rows;
-            cout << "Enter columns: ";
-            cin >> cols;
-            cout << "Enter number of mines: ";
-            cin >> mines;
-            
-            // Validate custom settings
-            if (rows <= 0 || cols <= 0 || mines <= 0 || mines >= rows * cols) {
-                cout << "Invalid settings! Using beginner mode.\n";
-                rows = 9; cols = 9; mines = 10;
-            }
-            break;
-        default:
-            cout << "Invalid choice! Using beginner mode.\n";
-            rows = 9; cols = 9; mines = 10;
+    long long revealed = 0, batches = 0, boundary = 0, deltas = 0;
+    for (int s = 0; s < shardCount; s++) {
+        const ShardedWorld::ShardStats& stats = world.stats(s);
+        revealed += stats.cellsRevealed;
+        batches += stats.batchesIn;
+        boundary += stats.boundaryCellsIn;
+        deltas += stats.deltasSent;
+    }
+    cout << "shards=" << shardCount << " players=" << players << " moves=" << (long long)players * (MOVES + 1)
+         << " cells_revealed=" << revealed << " mine_hits=" << world.getMineHits() << " rounds=" << world.getRounds()
+         << " batches=" << batches << " boundary_cells=" << boundary << " deltas=" << deltas
+         << " seconds=" << seconds << "\n";
+    for (int s = 0; s < shardCount; s++) {
+        const ShardedWorld::ShardStats& stats = world.stats(s);
+        cout << "shard=" << s << " tiles=" << world.tileCount(s) << " ring_tiles=" << world.ringTileCount(s)
+             << " kib=" << world.memoryBytes(s) / 1024
+             << " cells_revealed=" << stats.cellsRevealed << " batches_in=" << stats.batchesIn
+             << " boundary_cells_in=" << stats.boundaryCellsIn << " deltas_sent=" << stats.deltasSent << "\n";
     }
+    return 0;
 }
 
-int main() {
-    int rows, cols, mines;
+// Endless mode: an unbounded chunked board viewed through a moving window.
+// Coordinates are absolute and may be negative; the game opens with a free
+// zero region near the origin and ends on the first mine.
+int runEndless(uint64_t seed, double density, CommandScanner& input) {
+    if (density < ChunkedBoard::MIN_ENDLESS_DENSITY || density >= 1) {
+        cerr << "Endless density must be in [" << ChunkedBoard::MIN_ENDLESS_DENSITY << ", 1)\n";
+        return 1;
+    }
+    ChunkedBoard board(seed, density);
+    long long x = 0, y = 0;
+    if (!board.findOpening(x, y)) {
+        cerr << "No opening found near the origin\n";
+        return 1;
+    }
+    board.reveal(x, y);
+    
+    cout << "Endless Minesweeper (seed " << seed << ", density " << density << ")\n";
+    cout << "Commands: r x y, f x y, v x y (center view on x,y), q\n";
+    
+    const int windowRows = 20, windowCols = 40;
+    TerminalRenderer renderer;
+    renderer.attach(windowRows, windowCols);
+    long long originRow = x - windowRows / 2, originCol = y - windowCols / 2;
+    vector<uint8_t> buffer;
+    string message;
+    while (true) {
+        renderer.setLabelOrigin(originRow, originCol);
+        BoardView window = board.window(originRow, originCol, windowRows, windowCols, buffer);
+        string status = "View: (" + to_string(originRow) + "," + to_string(originCol) + ")" +
+                        " | Revealed: " + to_string(board.getRevealedSafe()) +
+                        " | Flags: " + to_string(board.getFlagsPlaced()) +
+                        " | Tiles: " + to_string(board.tileCount()) + " + " + to_string(board.ringTileCount()) +
+                        " ring (" + to_string(board.memoryBytes() / 1024) + " KiB)\n" + message;
+        renderer.drawFull(window, board.isMineHit(), status);
+        message.clear();
+        if (board.isMineHit()) {
+            cout << "💥 Game Over! You hit a mine! 💥\n";
+            return 0;
+        }
+        
+        cout << "Enter command: ";
+        cout.flush();
+        const char* p;
+        const char* last;
+        char command = '#';
+        long long args[2];
+        int argc = 0;
+        bool more = input.nextLine(p, last);
+        if (more && !parseCommand(p, last, command, args, argc)) continue;   // comment line
+        if (!more || (command == 'q' && argc == 0)) {
+            cout << "Thanks for playing!\n";
+            return 0;
+        }
+        if (command != 'r' && command != 'f' && command != 'v') {
+            message = "Invalid command! (line " + to_string(input.line()) + ")\n";
+            continue;
+        }
+        if (argc != 2) {
+            message = "Invalid coordinates! (line " + to_string(input.line()) + ")\n";
+            continue;
+        }
+        long long cx = args[0], cy = args[1];
+        if (command == 'v' || cx < originRow || cx >= originRow + windowRows ||
+            cy < originCol || cy >= originCol + windowCols) {
+            originRow = cx - windowRows / 2;
+            originCol = cy - windowCols / 2;
+        }
+        if (command == 'r') board.reveal(cx, cy);
+        else if (command == 'f') board.toggleFlag(cx, cy);
+    }
+}
+
+// Dumps the instrumentation counters when main returns (--stats)
+struct StatsAtExit {
+    int format = 0;              // 0 = off, 1 = text, 2 = JSON
+    ~StatsAtExit() {
+        if (format != 0) dumpInstrumentation(cerr, format == 2);
+    }
+};
+
+int main(int argc, char* argv[]) {
+    StatsAtExit statsAtExit;
+    int rows = 9, cols = 9, mines = 10;
+    uint64_t seed = randomSeed();
+    bool seedGiven = false;
+    string batchPath;
+    bool batchBinary = false;
+    StartMode start = START_ANYWHERE;
+    bool bench = false;
+    bool verify = false;
+    string baselinePath;
+    double benchSeconds = 0.2;
+    double verifySeconds = 0.05;
+    size_t generateCount = 0;
+    long long autoplayGames = 0;
+    long long simulateGames = 0;
+    int threads = (int)max(1u, thread::hardware_concurrency());
+    string outPath;
+    bool endless = false;
+    double density = 0.16;
+    string loadPath;
+    int serverPort = 0;
+    string recordPath, replayPath;
+    int worldShards = 0;
+    int players = 64;
+    
+    // Command-line options: fixed seed, board size and the non-interactive modes
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--seed" && hasValue) {
+            seed = strtoull(argv[++i], nullptr, 10);
+            seedGiven = true;
+        } else if (arg == "--rows" && hasValue) {
+            rows = atoi(argv[++i]);
+        } else if (arg == "--cols" && hasValue) {
+            cols = atoi(argv[++i]);
+        } else if (arg == "--mines" && hasValue) {
+            mines = atoi(argv[++i]);
+        } else if ((arg == "--batch" || arg == "--batch-binary") && hasValue) {
+            batchPath = argv[++i];
+            batchBinary = arg == "--batch-binary";
+        } else if (arg == "--safe-start") {
+            start = START_SAFE;
+        } else if (arg == "--no-guess") {
+            start = START_NO_GUESS;
+        } else if (arg == "--bench") {
+            bench = true;
+        } else if (arg == "--verify") {
+            verify = true;
+        } else if (arg == "--baseline" && hasValue) {
+            baselinePath = argv[++i];
+        } else if (arg == "--bench-time" && hasValue) {
+            benchSeconds = verifySeconds = atof(argv[++i]);
+        } else if (arg == "--generate" && hasValue) {
+            generateCount = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--autoplay" && hasValue) {
+            autoplayGames = atoll(argv[++i]);
+        } else if (arg == "--simulate" && hasValue) {
+            simulateGames = atoll(argv[++i]);
+        } else if (arg == "--threads" && hasValue) {
+            threads = max(1, atoi(argv[++i]));
+        } else if (arg == "--stats" && hasValue) {
+            string format = argv[++i];
+            statsAtExit.format = format == "json" ? 2 : 1;
+        } else if (arg == "--server" && hasValue) {
+            serverPort = atoi(argv[++i]);
+        } else if (arg == "--load" && hasValue) {
+            loadPath = argv[++i];
+        } else if (arg == "--endless") {
+            endless = true;
+        } else if (arg == "--density" && hasValue) {
+            density = atof(argv[++i]);
+        } else if (arg == "--world" && hasValue) {
+            worldShards = max(1, atoi(argv[++i]));
+        } else if (arg == "--players" && hasValue) {
+            players = max(1, atoi(argv[++i]));
+        } else if (arg == "--record" && hasValue) {
+            recordPath = argv[++i];
+        } else if (arg == "--replay-log" && hasValue) {
+            replayPath = argv[++i];
+        } else if (arg == "--out" && hasValue) {
+            outPath = argv[++i];
+        } else {
+            cerr << "Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+    
+    if (bench) {
+        return runBenchmarks(seedGiven ? seed : 1, benchSeconds);
+    }
+    if (verify) {
+        return runVerify(seedGiven ? seed : 1, verifySeconds, baselinePath);
+    }
+    
+    if (!replayPath.empty()) {
+        return runReplayLog(replayPath);
+    }
+    if (worldShards > 0) {
+        return runWorld(worldShards, players, seed, density);
+    }
+    
+    CommandScanner input;
+    if (endless) {
+        return runEndless(seed, density, input);
+    }
+    
+    if (!batchPath.empty() || generateCount > 0 || autoplayGames > 0 || simulateGames > 0 || serverPort > 0) {
+        if (!validSettings(rows, cols, mines)) {
+            cerr << "Invalid board settings\n";
+            return 1;
+        }
+        GameLogWriter log;
+        if (!recordPath.empty() && !log.open(recordPath)) {
+            cerr << "Cannot open game log: " << recordPath << "\n";
+            return 1;
+        }
+        GameLogWriter* gameLog = recordPath.empty() ? nullptr : &log;
+        // A log that could not be written in full fails the run
+        auto closeLog = [&](int status) {
+            if (gameLog && !log.close()) {
+                cerr << "Cannot write game log: " << recordPath << "\n";
+                return 1;
+            }
+            return status;
+        };
+        if (serverPort > 0) {
+#if defined(__linux__)
+            return closeLog(GameServer(serverPort, rows, cols, mines, seed, start, gameLog).run(threads));
+#else
+            cerr << "--server needs Linux (epoll)\n";
+            return 1;
+#endif
+        }
+        if (autoplayGames > 0) {
+            return closeLog(runAutoplay(autoplayGames, rows, cols, mines, seed, start, gameLog));
+        }
+        if (simulateGames > 0) {
+            if (start == START_NO_GUESS) {
+                cerr << "--simulate does not support --no-guess\n";
+                return 1;
+            }
+            return runSimulate(simulateGames, threads, outPath, rows, cols, mines, seed, start);
+        }
+        if (generateCount > 0) {
+            return runGenerate(generateCount, threads, outPath, rows, cols, mines, seed);
+        }
+        return runBatch(batchPath, batchBinary, rows, cols, mines, seed, start);
+    }
     
     cout << "=== MINESWEEPER GAME ===" << endl;
     cout << "C++ Implementation using DSA" << endl;
     cout << "=========================" << endl << endl;
     
-    getDifficultySettings(rows, cols, mines);
+    // Finished games are followed by new boards of the same size (the next
+    // seeds of the stream) for as long as the player wants, so the
+    // leaderboard ranks every win of the session
+    LeaderboardService leaderboard;
+    auto playSession = [&](Minesweeper& game) {
+        game.playGame(input, &leaderboard);
+        for (uint64_t round = 1; (game.isGameOver() || game.isGameWon()) && askPlayAgain(input); round++) {
+            game.reset(streamSeed(seed, round));
+            game.playGame(input, &leaderboard);
+        }
+    };
+    
+    if (!loadPath.empty()) {
+        Minesweeper game(1, 1, 0, seed);
+        string error;
+        if (!game.load(loadPath, error)) {
+            cerr << "Cannot load " << loadPath << ": " << error << "\n";
+            return 1;
+        }
+        playSession(game);
+        return 0;
+    }
+    
+    getDifficultySettings(rows, cols, mines, input);
     
     // Create and start the game
-    Minesweeper game(rows, cols, mines);
-    game.playGame();
+    Minesweeper game(rows, cols, mines, seed, start);
+    playSession(game);
     
     return 0;
 }